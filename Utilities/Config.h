@@ -219,6 +219,11 @@ namespace cfg
 		{
 			return try_to_enum_list(&fmt_class_string<T>::format);
 		}
+
+		void set(const T& value)
+		{
+			m_value = value;
+		}
 	};
 
 	// Signed 32/64-bit integer entry with custom Min/Max range.
@@ -151,6 +151,11 @@ u8* jit_runtime::alloc(std::size_t size, uint align, bool exec) noexcept
 	}
 }
 
+u64 jit_runtime::usage(bool exec) noexcept
+{
+	return exec ? s_code_pos.load() : s_data_pos.load();
+}
+
 void jit_runtime::initialize()
 {
 	if (!s_code_init.empty() || !s_data_init.empty())
@@ -245,6 +250,8 @@ void asmjit::build_transaction_abort(asmjit::X86Assembler& c, unsigned char code
 #include "llvm/ExecutionEngine/RTDyldMemoryManager.h"
 #include "llvm/ExecutionEngine/JITEventListener.h"
 #include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Object/ObjectFile.h"
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
@@ -255,6 +262,8 @@ void asmjit::build_transaction_abort(asmjit::X86Assembler& c, unsigned char code
 #include <sys/mman.h>
 #endif
 
+#include <zlib.h>
+
 // Memory manager mutex
 shared_mutex s_mutex;
 
@@ -686,6 +695,267 @@ public:
 	}
 };
 
+// Object archive file header
+struct jit_archive_header
+{
+	u64 magic;
+	u32 version;
+	u32 reserved;
+};
+
+// Object archive record header (followed by the name and data)
+struct jit_archive_record
+{
+	u32 name_size;
+	u32 size;
+	u32 usize;
+	u32 crc;
+};
+
+static constexpr u64 c_archive_magic = "RPCS3JAR"_u64;
+static constexpr u32 c_archive_version = 1;
+
+jit_object_archive::jit_object_archive(const std::string& path)
+	: m_path(path)
+	, m_file(path, fs::read + fs::write + fs::create + fs::append)
+{
+	if (!m_file)
+	{
+		LOG_ERROR(GENERAL, "LLVM: Failed to open object archive %s (%s)", path, fs::g_tls_error);
+		return;
+	}
+
+	jit_archive_header header{};
+
+	if (!m_file.read(header) || header.magic != c_archive_magic || header.version != c_archive_version)
+	{
+		if (m_file.size())
+		{
+			LOG_ERROR(GENERAL, "LLVM: Object archive is incompatible and will be rebuilt: %s", path);
+		}
+
+		header.magic = c_archive_magic;
+		header.version = c_archive_version;
+		header.reserved = 0;
+		m_file.trunc(0);
+		m_file.write(header);
+	}
+
+	// Build index
+	const u64 size = m_file.size();
+	u64 pos = sizeof(header);
+
+	while (pos < size)
+	{
+		jit_archive_record rec;
+		std::string name;
+
+		m_file.seek(pos);
+
+		if (!m_file.read(rec) || pos + sizeof(rec) + rec.name_size + rec.size > size || !m_file.read(name, rec.name_size))
+		{
+			break;
+		}
+
+		m_index[name] = entry{pos + sizeof(rec) + rec.name_size, rec.size, rec.usize, rec.crc};
+		pos += sizeof(rec) + rec.name_size + rec.size;
+	}
+
+	if (pos < size)
+	{
+		// Drop incomplete record (interrupted write)
+		LOG_ERROR(GENERAL, "LLVM: Object archive is truncated at 0x%x: %s", pos, path);
+		m_file.trunc(pos);
+	}
+}
+
+jit_object_archive::~jit_object_archive()
+{
+}
+
+bool jit_object_archive::has(const std::string& name)
+{
+	reader_lock lock(m_mutex);
+	return m_index.count(name) != 0;
+}
+
+std::unique_ptr<llvm::MemoryBuffer> jit_object_archive::get(const std::string& name)
+{
+	std::lock_guard lock(m_mutex);
+
+	const auto found = m_index.find(name);
+
+	if (found == m_index.end())
+	{
+		return nullptr;
+	}
+
+	const entry e = found->second;
+
+	if (!m_map || e.pos + e.size > m_map->getBufferSize())
+	{
+		// Map the archive file
+		auto map = llvm::MemoryBuffer::getFile(m_path, -1, false);
+
+		if (!map)
+		{
+			LOG_ERROR(GENERAL, "LLVM: Failed to map object archive %s", m_path);
+			return nullptr;
+		}
+
+		m_map = std::move(map.get());
+
+		if (e.pos + e.size > m_map->getBufferSize())
+		{
+			return nullptr;
+		}
+	}
+
+	const auto data = reinterpret_cast<const Bytef*>(m_map->getBufferStart() + e.pos);
+
+	if (::crc32(0, data, e.size) != e.crc)
+	{
+		LOG_ERROR(GENERAL, "LLVM: Object %s is damaged (archive %s)", name, m_path);
+		return nullptr;
+	}
+
+	auto buf = llvm::WritableMemoryBuffer::getNewUninitMemBuffer(e.usize, name);
+
+	if (e.size == e.usize)
+	{
+		// Stored without compression
+		std::memcpy(buf->getBufferStart(), data, e.size);
+		return buf;
+	}
+
+	uLongf usize = e.usize;
+
+	if (::uncompress(reinterpret_cast<Bytef*>(buf->getBufferStart()), &usize, data, e.size) != Z_OK || usize != e.usize)
+	{
+		LOG_ERROR(GENERAL, "LLVM: Failed to decompress object %s (archive %s)", name, m_path);
+		return nullptr;
+	}
+
+	return buf;
+}
+
+void jit_object_archive::add(const std::string& name, const void* data, std::size_t size)
+{
+	if (!m_file)
+	{
+		return;
+	}
+
+	// Compress object (store uncompressed if it doesn't help)
+	std::vector<Bytef> zbuf(::compressBound(size));
+	uLongf zsize = zbuf.size();
+
+	if (::compress2(zbuf.data(), &zsize, static_cast<const Bytef*>(data), size, Z_BEST_SPEED) != Z_OK || zsize >= size)
+	{
+		zsize = size;
+		std::memcpy(zbuf.data(), data, size);
+	}
+
+	jit_archive_record rec;
+	rec.name_size = ::size32(name);
+	rec.size = static_cast<u32>(zsize);
+	rec.usize = static_cast<u32>(size);
+	rec.crc = ::crc32(0, zbuf.data(), rec.size);
+
+	std::lock_guard lock(m_mutex);
+
+	const u64 pos = m_file.size();
+	m_file.write(rec);
+	m_file.write(name);
+
+	if (m_file.write(zbuf.data(), zsize) != zsize)
+	{
+		LOG_ERROR(GENERAL, "LLVM: Failed to write object %s to archive %s", name, m_path);
+		m_file.trunc(pos);
+		return;
+	}
+
+	m_index[name] = entry{pos + sizeof(rec) + rec.name_size, rec.size, rec.usize, rec.crc};
+}
+
+void jit_object_archive::migrate(const std::string& dir)
+{
+	u32 count = 0;
+
+	for (auto&& entry : fs::dir(dir))
+	{
+		if (entry.is_directory || entry.name.size() < 4 || entry.name.compare(entry.name.size() - 4, 4, ".obj") != 0)
+		{
+			continue;
+		}
+
+		if (!has(entry.name))
+		{
+			const fs::file obj{dir + entry.name};
+
+			if (!obj)
+			{
+				continue;
+			}
+
+			const auto data = obj.to_vector<u8>();
+			add(entry.name, data.data(), data.size());
+
+			if (!has(entry.name))
+			{
+				continue;
+			}
+		}
+
+		fs::remove_file(dir + entry.name);
+		count++;
+	}
+
+	if (count)
+	{
+		LOG_SUCCESS(GENERAL, "LLVM: Moved %u object files to archive %s", count, m_path);
+	}
+}
+
+// Object cache writing to the archive
+class ArchiveCache final : public llvm::ObjectCache
+{
+	jit_object_archive& m_archive;
+
+public:
+	ArchiveCache(jit_object_archive& archive)
+		: m_archive(archive)
+	{
+	}
+
+	~ArchiveCache() override = default;
+
+	void notifyObjectCompiled(const llvm::Module* module, llvm::MemoryBufferRef obj) override
+	{
+		m_archive.add(module->getName(), obj.getBufferStart(), obj.getBufferSize());
+		LOG_NOTICE(GENERAL, "LLVM: Created module: %s", module->getName().data());
+	}
+
+	std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module* module) override
+	{
+		if (auto buf = m_archive.get(module->getName()))
+		{
+			// Validate the object (the module is recompiled if it can't be parsed)
+			if (auto obj = llvm::object::ObjectFile::createObjectFile(buf->getMemBufferRef()); !obj)
+			{
+				llvm::consumeError(obj.takeError());
+				LOG_ERROR(GENERAL, "LLVM: Invalid object in archive: %s", module->getName().data());
+				return nullptr;
+			}
+
+			LOG_NOTICE(GENERAL, "LLVM: Loaded module: %s", module->getName().data());
+			return buf;
+		}
+
+		return nullptr;
+	}
+};
+
 std::string jit_compiler::cpu(const std::string& _cpu)
 {
 	std::string m_cpu = _cpu;
@@ -808,6 +1078,23 @@ void jit_compiler::add(std::unique_ptr<llvm::Module> module, const std::string&
 	}
 }
 
+void jit_compiler::add(std::unique_ptr<llvm::Module> module, jit_object_archive& archive)
+{
+	ArchiveCache cache{archive};
+	m_engine->setObjectCache(&cache);
+
+	const auto ptr = module.get();
+	m_engine->addModule(std::move(module));
+	m_engine->generateCodeForModule(ptr);
+	m_engine->setObjectCache(nullptr);
+
+	for (auto& func : ptr->functions())
+	{
+		// Delete IR to lower memory consumption
+		func.deleteBody();
+	}
+}
+
 void jit_compiler::add(std::unique_ptr<llvm::Module> module)
 {
 	const auto ptr = module.get();
@@ -826,6 +1113,28 @@ void jit_compiler::add(const std::string& path)
 	m_engine->addObjectFile(std::move(llvm::object::ObjectFile::createObjectFile(*ObjectCache::load(path)).get()));
 }
 
+bool jit_compiler::add(const std::string& name, jit_object_archive& archive)
+{
+	auto buf = archive.get(name);
+
+	if (!buf)
+	{
+		return false;
+	}
+
+	auto obj = llvm::object::ObjectFile::createObjectFile(buf->getMemBufferRef());
+
+	if (!obj)
+	{
+		llvm::consumeError(obj.takeError());
+		LOG_ERROR(GENERAL, "LLVM: Invalid object %s", name);
+		return false;
+	}
+
+	m_engine->addObjectFile({std::move(*obj), std::move(buf)});
+	return true;
+}
+
 void jit_compiler::fin()
 {
 	m_engine->finalizeObject();
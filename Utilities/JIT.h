@@ -30,6 +30,9 @@ struct jit_runtime final : asmjit::HostRuntime
 	// Allocate memory
 	static u8* alloc(std::size_t size, uint align, bool exec = true) noexcept;
 
+	// Get the amount of allocated memory
+	static u64 usage(bool exec = true) noexcept;
+
 	// Should be called at least once after global initialization
 	static void initialize();
 
@@ -96,6 +99,7 @@ FT build_function_asm(F&& builder)
 
 #include "types.h"
 #include "mutex.h"
+#include "File.h"
 
 #include "restore_new.h"
 #ifdef _MSC_VER
@@ -109,6 +113,47 @@ FT build_function_asm(F&& builder)
 #endif
 #include "define_new_memleakdetect.h"
 
+// Single-file object cache (compressed objects indexed by name)
+class jit_object_archive final
+{
+	struct entry
+	{
+		u64 pos; // Data position
+		u32 size; // Stored size
+		u32 usize; // Uncompressed size
+		u32 crc; // Stored data checksum
+	};
+
+	const std::string m_path;
+
+	shared_mutex m_mutex;
+
+	// Object name -> location
+	std::unordered_map<std::string, entry> m_index;
+
+	// Mapped archive (remapped if objects are added)
+	std::unique_ptr<llvm::MemoryBuffer> m_map;
+
+	// Archive file (append only)
+	fs::file m_file;
+
+public:
+	jit_object_archive(const std::string& path);
+	~jit_object_archive();
+
+	// Check whether the object is present
+	bool has(const std::string& name);
+
+	// Load object (returns nullptr if not found or damaged)
+	std::unique_ptr<llvm::MemoryBuffer> get(const std::string& name);
+
+	// Add object
+	void add(const std::string& name, const void* data, std::size_t size);
+
+	// Move loose object files from the directory into the archive
+	void migrate(const std::string& dir);
+};
+
 // Temporary compiler interface
 class jit_compiler final
 {
@@ -145,12 +190,18 @@ public:
 	// Add module (path to obj cache dir)
 	void add(std::unique_ptr<llvm::Module> module, const std::string& path);
 
+	// Add module (object is stored in the archive)
+	void add(std::unique_ptr<llvm::Module> module, jit_object_archive& archive);
+
 	// Add module (not cached)
 	void add(std::unique_ptr<llvm::Module> module);
 
 	// Add object (path to obj file)
 	void add(const std::string& path);
 
+	// Add object from the archive
+	bool add(const std::string& name, jit_object_archive& archive);
+
 	// Finalize
 	void fin();
 
@@ -9,6 +9,7 @@
 #include "Emu/Cell/lv2/sys_event.h"
 #include "Thread.h"
 #include "sysinfo.h"
+#include "asm.h"
 #include <typeinfo>
 #include <thread>
 
@@ -1987,8 +1988,221 @@ void thread_ctrl::detect_cpu_layout()
 	}
 }
 
-u16 thread_ctrl::get_affinity_mask(thread_class group)
+#ifdef __linux__
+// Parse CPU list in sysfs format ("0-3,8,10-11"), CPUs above 63 are ignored
+static u64 parse_cpu_list(const std::string& list)
+{
+	u64 result = 0;
+
+	for (std::size_t pos = 0; pos < list.size();)
+	{
+		std::size_t next = list.find(',', pos);
+
+		if (next == std::string::npos)
+		{
+			next = list.size();
+		}
+
+		const std::string range = list.substr(pos, next - pos);
+		const std::size_t dash = range.find('-');
+
+		const u32 first = std::strtoul(range.c_str(), nullptr, 10);
+		const u32 last = dash == std::string::npos ? first : std::strtoul(range.c_str() + dash + 1, nullptr, 10);
+
+		for (u32 cpu = first; cpu <= last && cpu < 64; cpu++)
+		{
+			result |= 1ull << cpu;
+		}
+
+		pos = next + 1;
+	}
+
+	return result;
+}
+
+static u64 read_cpu_list(const std::string& path)
+{
+	if (fs::file f{path})
+	{
+		// sysfs attributes report page size, read until EOF
+		std::string data;
+		char buf[256];
+
+		while (const u64 count = f.read(buf, sizeof(buf)))
+		{
+			data.append(buf, count);
+		}
+
+		return parse_cpu_list(data);
+	}
+
+	return 0;
+}
+
+static u32 popcnt_mask(u64 mask)
+{
+	return utils::popcnt32(static_cast<u32>(mask)) + utils::popcnt32(static_cast<u32>(mask >> 32));
+}
+
+// Thread placement computed from sysfs CPU topology (L3 cache groups, SMT siblings, NUMA nodes)
+struct cpu_topology_layout
 {
+	bool valid = false;
+	u64 rsx = 0;
+	u64 ppu = 0;
+	std::vector<u64> spu; // Per SPU thread group
+
+	cpu_topology_layout()
+	{
+		// Logical CPUs sharing L3 cache
+		struct domain
+		{
+			u64 mask = 0; // All logical CPUs
+			u64 cores = 0; // First logical CPU of each physical core
+			u32 node = 0; // NUMA node
+		};
+
+		std::vector<domain> domains;
+
+		const u32 count = std::min<u32>(std::thread::hardware_concurrency(), 64);
+
+		for (u32 cpu = 0; cpu < count; cpu++)
+		{
+			const std::string base = fmt::format("/sys/devices/system/cpu/cpu%u/", cpu);
+
+			// Offline CPUs have no topology directory
+			if (!fs::is_dir(base + "topology"))
+			{
+				continue;
+			}
+
+			u64 siblings = read_cpu_list(base + "topology/thread_siblings_list");
+			u64 l3 = read_cpu_list(base + "cache/index3/shared_cpu_list");
+
+			if (!siblings)
+			{
+				siblings = 1ull << cpu;
+			}
+
+			if (!l3)
+			{
+				// Fallback to physical package
+				l3 = read_cpu_list(base + "topology/core_siblings_list");
+			}
+
+			if (!l3)
+			{
+				return;
+			}
+
+			auto found = std::find_if(domains.begin(), domains.end(), [&](const domain& d) { return d.mask & l3; });
+
+			if (found == domains.end())
+			{
+				found = domains.emplace(domains.end());
+			}
+
+			found->mask |= 1ull << cpu;
+
+			if (utils::cnttz64(siblings, true) == cpu)
+			{
+				found->cores |= 1ull << cpu;
+			}
+		}
+
+		if (domains.size() < 2)
+		{
+			// Nothing to choose from, keep default placement
+			return;
+		}
+
+		for (u32 node = 0; node < 64; node++)
+		{
+			const std::string path = fmt::format("/sys/devices/system/node/node%u/cpulist", node);
+
+			if (!fs::is_file(path))
+			{
+				continue;
+			}
+
+			const u64 node_mask = read_cpu_list(path);
+
+			for (auto& d : domains)
+			{
+				if (d.mask & node_mask)
+				{
+					d.node = node;
+				}
+			}
+		}
+
+		// Largest domain on the first NUMA node goes first
+		std::stable_sort(domains.begin(), domains.end(), [](const domain& a, const domain& b)
+		{
+			if (a.node != b.node)
+			{
+				return a.node < b.node;
+			}
+
+			return popcnt_mask(a.mask) > popcnt_mask(b.mask);
+		});
+
+		// RSX and PPU threads share the primary cache domain
+		rsx = domains[0].mask;
+		ppu = domains[0].mask;
+
+		// SPU thread groups are spread over the other domains of the same node (or any other domain)
+		for (int pass = 0; pass < 2 && spu.empty(); pass++)
+		{
+			for (std::size_t i = 1; i < domains.size(); i++)
+			{
+				const auto& d = domains[i];
+
+				if (pass == 0 && d.node != domains[0].node)
+				{
+					continue;
+				}
+
+				// Avoid SMT siblings if there are enough physical cores for a full group
+				spu.push_back(popcnt_mask(d.cores) >= 6 ? d.cores : d.mask);
+			}
+		}
+
+		valid = true;
+
+		std::string spu_str;
+
+		for (u64 mask : spu)
+		{
+			fmt::append(spu_str, " 0x%llx", mask);
+		}
+
+		LOG_NOTICE(GENERAL, "Thread placement: %u cache domains; RSX/PPU: 0x%llx (node %u); SPU groups:%s", domains.size(), rsx, domains[0].node, spu_str);
+	}
+};
+#endif
+
+u64 thread_ctrl::get_affinity_mask(thread_class group, u32 index)
+{
+#ifdef __linux__
+	static const cpu_topology_layout s_layout;
+
+	if (s_layout.valid)
+	{
+		switch (group)
+		{
+		case thread_class::rsx:
+			return s_layout.rsx;
+		case thread_class::ppu:
+			return s_layout.ppu;
+		case thread_class::spu:
+			return s_layout.spu[index % s_layout.spu.size()];
+		default:
+			break;
+		}
+	}
+#endif
+
 	detect_cpu_layout();
 
 	if (const auto thread_count = std::thread::hardware_concurrency())
@@ -2098,7 +2312,7 @@ void thread_ctrl::set_native_priority(int priority)
 #endif
 }
 
-void thread_ctrl::set_thread_affinity_mask(u16 mask)
+void thread_ctrl::set_thread_affinity_mask(u64 mask)
 {
 #ifdef _WIN32
 	HANDLE _this_thread = GetCurrentThread();
@@ -2111,9 +2325,9 @@ void thread_ctrl::set_thread_affinity_mask(u16 mask)
 	cpu_set_t cs;
 	CPU_ZERO(&cs);
 
-	for (u32 core = 0; core < 16u; ++core)
+	for (u32 core = 0; core < 64u; ++core)
 	{
-		if ((u32)mask & (1u << core))
+		if (mask & (1ull << core))
 		{
 			CPU_SET(core, &cs);
 		}
@@ -257,14 +257,14 @@ public:
 	// Detect layout
 	static void detect_cpu_layout();
 
-	// Returns a core affinity mask. Set whether to generate the high priority set or not
-	static u16 get_affinity_mask(thread_class group);
+	// Returns a core affinity mask for the thread class (index selects SPU thread group placement)
+	static u64 get_affinity_mask(thread_class group, u32 index = 0);
 
 	// Sets the native thread priority
 	static void set_native_priority(int priority);
 
 	// Sets the preferred affinity mask for this thread
-	static void set_thread_affinity_mask(u16 mask);
+	static void set_thread_affinity_mask(u64 mask);
 
 	// Spawn a detached named thread
 	template <typename F>
@@ -0,0 +1,170 @@
+#include "stdafx.h"
+#include "Emu/System.h"
+#include "CPUCompileScheduler.h"
+
+#include <thread>
+
+extern atomic_t<const char*> g_progr;
+
+// Progress dialog message for each job class
+static const char* const s_progr_msg[]
+{
+	"Compiling PPU modules...",
+	"Compiling PPU modules...",
+	"Building SPU cache...",
+	nullptr, // Background work, no progress dialog
+};
+
+struct compile_scheduler::worker
+{
+	compile_scheduler* const sched;
+
+	void operator()()
+	{
+		// Set low priority
+		thread_ctrl::set_native_priority(-1);
+
+		std::unique_lock lock(sched->m_mutex);
+
+		while (true)
+		{
+			job next{};
+			u32 prio = 0;
+
+			// Take the oldest job of the highest priority
+			for (; prio < sched->m_queue.size(); prio++)
+			{
+				if (!sched->m_queue[prio].empty())
+				{
+					next = std::move(sched->m_queue[prio].front());
+					sched->m_queue[prio].pop_front();
+					sched->m_queued[prio]--;
+					break;
+				}
+			}
+
+			if (next.func && Emu.IsStopped())
+			{
+				// Drop pending jobs (waiters check the emulation state)
+				if (!--next.grp->m_pending)
+				{
+					sched->m_done.notify_all();
+				}
+
+				continue;
+			}
+
+			if (!next.func)
+			{
+				// Remaining jobs are always completed before stopping, exit early with the emulation
+				// (workers are counted in g_thread_count which Emulator::Stop waits for)
+				if (sched->m_stop || Emu.IsStopped() || thread_ctrl::state() == thread_state::aborting)
+				{
+					break;
+				}
+
+				sched->m_cond.wait(lock, 10000);
+				continue;
+			}
+
+			lock.unlock();
+
+			if (s_progr_msg[prio])
+			{
+				g_progr = s_progr_msg[prio];
+			}
+
+			next.func();
+
+			lock.lock();
+
+			if (!--next.grp->m_pending)
+			{
+				sched->m_done.notify_all();
+			}
+		}
+	}
+};
+
+compile_scheduler::compile_scheduler()
+{
+	// Initialize the pool with the max number of threads
+	const u32 max_threads = static_cast<u32>(g_cfg.core.llvm_threads);
+	const u32 thread_count = max_threads > 0 ? std::min(max_threads, std::thread::hardware_concurrency()) : std::thread::hardware_concurrency();
+
+	for (u32 i = 0; i < std::max<u32>(thread_count, 1); i++)
+	{
+		m_workers.emplace_back(std::make_unique<named_thread<worker>>("Compiler Worker " + std::to_string(i), worker{this}));
+	}
+}
+
+compile_scheduler::~compile_scheduler()
+{
+	{
+		std::lock_guard lock(m_mutex);
+		m_stop = true;
+	}
+
+	m_cond.notify_all();
+	m_workers.clear();
+}
+
+void compile_scheduler::push(compile_priority prio, group& grp, std::function<void()> func)
+{
+	{
+		std::lock_guard lock(m_mutex);
+		grp.m_pending++;
+		m_queue[static_cast<u32>(prio)].emplace_back(job{std::move(func), &grp});
+		m_queued[static_cast<u32>(prio)]++;
+	}
+
+	m_cond.notify_one();
+}
+
+bool compile_scheduler::preempted(compile_priority prio) const
+{
+	for (u32 i = 0; i < static_cast<u32>(prio); i++)
+	{
+		if (m_queued[i])
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void compile_scheduler::wait(group& grp)
+{
+	std::unique_lock lock(m_mutex);
+
+	while (grp.m_pending)
+	{
+		if (Emu.IsStopped())
+		{
+			// Workers may have already exited: drop queued jobs of the group, only wait for running ones
+			for (u32 prio = 0; prio < m_queue.size(); prio++)
+			{
+				for (auto it = m_queue[prio].begin(); it != m_queue[prio].end();)
+				{
+					if (it->grp == &grp)
+					{
+						it = m_queue[prio].erase(it);
+						m_queued[prio]--;
+						grp.m_pending--;
+						continue;
+					}
+
+					it++;
+				}
+			}
+
+			if (!grp.m_pending)
+			{
+				break;
+			}
+		}
+
+		m_done.wait(lock, 10000);
+	}
+}
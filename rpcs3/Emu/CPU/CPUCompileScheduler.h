@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Utilities/types.h"
+#include "Utilities/Atomic.h"
+#include "Utilities/Thread.h"
+#include "Utilities/mutex.h"
+#include "Utilities/cond.h"
+
+#include <array>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <functional>
+
+// Compilation job class (lower value is scheduled first)
+enum class compile_priority : u32
+{
+	ppu_main, // Main executable
+	ppu_prx, // PRX modules
+	spu_cache, // SPU cache
+	spu_relocate, // SPU functions kept after JIT eviction (background)
+
+	__count
+};
+
+// Process-wide pool of compiler threads shared by PPU and SPU precompilation
+class compile_scheduler
+{
+public:
+	// Set of jobs which can be waited for
+	class group
+	{
+		atomic_t<u32> m_pending{0};
+
+		friend class compile_scheduler;
+	};
+
+private:
+	struct job
+	{
+		std::function<void()> func;
+		group* grp;
+	};
+
+	struct worker;
+
+	shared_mutex m_mutex;
+
+	// Signaled on new jobs
+	cond_variable m_cond;
+
+	// Signaled on group completion
+	cond_variable m_done;
+
+	// Job queues for each priority
+	std::array<std::deque<job>, static_cast<u32>(compile_priority::__count)> m_queue;
+
+	// Number of queued jobs (per priority)
+	std::array<atomic_t<u32>, static_cast<u32>(compile_priority::__count)> m_queued{};
+
+	bool m_stop = false;
+
+	std::vector<std::unique_ptr<named_thread<worker>>> m_workers;
+
+public:
+	compile_scheduler();
+
+	~compile_scheduler();
+
+	// Get the number of worker threads
+	u32 size() const
+	{
+		return ::size32(m_workers);
+	}
+
+	// Add job to the group
+	void push(compile_priority prio, group& grp, std::function<void()> func);
+
+	// Check whether a job of higher priority is waiting (long jobs should yield and push the continuation)
+	bool preempted(compile_priority prio) const;
+
+	// Wait for the completion of all jobs in the group (queued jobs are dropped if the emulation is stopped)
+	void wait(group& grp);
+};
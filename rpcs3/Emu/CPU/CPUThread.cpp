@@ -6,6 +6,7 @@
 #include "Utilities/GDBDebugServer.h"
 #include "Emu/Cell/PPUThread.h"
 #include "Emu/Cell/SPUThread.h"
+#include "Emu/Cell/lv2/sys_spu.h"
 
 DECLARE(cpu_thread::g_threads_created){0};
 DECLARE(cpu_thread::g_threads_deleted){0};
@@ -30,6 +31,7 @@ void fmt_class_string<cpu_flag>::format(std::string& out, u64 arg)
 		case cpu_flag::dbg_global_stop: return "G-EXIT";
 		case cpu_flag::dbg_pause: return "PAUSE";
 		case cpu_flag::dbg_step: return "STEP";
+		case cpu_flag::epoch: return "e";
 		case cpu_flag::__bitset_enum_max: break;
 		}
 
@@ -54,6 +56,9 @@ alignas(64) shared_mutex g_cpu_pause_lock;
 // For cpu_flag::pause
 alignas(64) atomic_t<u64> g_cpu_pause_ctr{0};
 
+// Global epoch for quiescent state detection
+alignas(64) atomic_t<u64> g_cpu_epoch{0};
+
 // Semaphore for global thread array (global counter)
 alignas(64) atomic_t<u32> g_cpu_array_sema{0};
 
@@ -80,13 +85,50 @@ void for_all_cpu(F&& func) noexcept
 	}
 }
 
+// Call func for all registered threads while holding a reader lock (returns false if the lock can't be obtained)
+template <typename F>
+bool for_all_cpu_locked(F&& func) noexcept
+{
+	auto lock = g_cpu_array_lock.try_shared_lock();
+
+	if (!lock)
+	{
+		return false;
+	}
+
+	// Threads can't unregister (and be destroyed) while the lock is held
+	for_all_cpu(func);
+
+	// Unlock and wake up threads waiting for registration or unregistration
+	while (!g_cpu_array_lock.wait_all(lock))
+	{
+		if (g_cpu_array_lock.notify_all(lock))
+		{
+			break;
+		}
+	}
+
+	return true;
+}
+
 void cpu_thread::operator()()
 {
 	g_tls_current_cpu_thread = this;
 
 	if (g_cfg.core.thread_scheduler_enabled)
 	{
-		thread_ctrl::set_thread_affinity_mask(thread_ctrl::get_affinity_mask(id_type() == 1 ? thread_class::ppu : thread_class::spu));
+		if (id_type() == 1)
+		{
+			thread_ctrl::set_thread_affinity_mask(thread_ctrl::get_affinity_mask(thread_class::ppu));
+		}
+		else
+		{
+			// Threads of the same group are placed together
+			const auto group = static_cast<spu_thread*>(this)->group;
+			const u32 index = group ? (group->id - lv2_spu_group::id_base) / lv2_spu_group::id_step : 0;
+
+			thread_ctrl::set_thread_affinity_mask(thread_ctrl::get_affinity_mask(thread_class::spu, index));
+		}
 	}
 
 	if (g_cfg.core.lower_spu_priority && id_type() == 2)
@@ -130,6 +172,8 @@ void cpu_thread::operator()()
 		}
 	}
 
+	start_tsc = __rdtsc();
+
 	// Register and wait if necessary
 	verify("g_cpu_array[...] -> this" HERE), g_cpu_array[array_slot].exchange(this) == nullptr;
 
@@ -202,11 +246,23 @@ bool cpu_thread::check_state() noexcept
 	bool cpu_sleep_called = false;
 	bool cpu_flag_memory = false;
 
+	// Stall accounting (start timestamp is set on the first blocking iteration)
+	u64 stall_start = 0;
+	cpu_stall stall_type = cpu_stall::pause;
+
 	if (!(state & cpu_flag::wait))
 	{
 		state += cpu_flag::wait;
 	}
 
+	// Publish quiescent state (clear request flag first to not miss the next epoch)
+	if (state & cpu_flag::epoch)
+	{
+		state -= cpu_flag::epoch;
+	}
+
+	epoch.release(g_cpu_epoch.load());
+
 	while (true)
 	{
 		if (state & cpu_flag::memory)
@@ -223,6 +279,11 @@ bool cpu_thread::check_state() noexcept
 
 		if (state & (cpu_flag::exit + cpu_flag::jit_return + cpu_flag::dbg_global_stop))
 		{
+			if (stall_start)
+			{
+				add_stall(stall_type, __rdtsc() - stall_start);
+			}
+
 			state += cpu_flag::wait;
 			return true;
 		}
@@ -251,6 +312,11 @@ bool cpu_thread::check_state() noexcept
 
 		if (escape)
 		{
+			if (stall_start)
+			{
+				add_stall(stall_type, __rdtsc() - stall_start);
+			}
+
 			if (cpu_flag_memory)
 			{
 				cpu_mem();
@@ -258,7 +324,15 @@ bool cpu_thread::check_state() noexcept
 
 			break;
 		}
-		else if (!cpu_sleep_called && state0 & cpu_flag::suspend)
+
+		// Not accounted inside of an outer cpu_stall_scope
+		if (!stall_start && !stall_depth)
+		{
+			stall_start = __rdtsc();
+			stall_type = state0 & cpu_flag::suspend ? cpu_stall::suspend : cpu_stall::pause;
+		}
+
+		if (!cpu_sleep_called && state0 & cpu_flag::suspend)
 		{
 			cpu_sleep();
 			cpu_sleep_called = true;
@@ -334,6 +408,149 @@ std::string cpu_thread::dump() const
 	return fmt::format("Type: %s\n" "State: %s\n", typeid(*this).name(), state.load());
 }
 
+u32 cpu_thread::get_stall_totals(u64 (&out)[static_cast<u32>(cpu_stall::__max)], u64* total)
+{
+	const u64 now = __rdtsc();
+
+	u32 count = 0;
+
+	std::fill(std::begin(out), std::end(out), 0);
+
+	if (total)
+	{
+		*total = 0;
+	}
+
+	for_all_cpu_locked([&](cpu_thread* cpu)
+	{
+		for (u32 i = 0; i < static_cast<u32>(cpu_stall::__max); i++)
+		{
+			out[i] += cpu->stall_tsc[i];
+		}
+
+		if (total)
+		{
+			*total += now - cpu->start_tsc;
+		}
+
+		count++;
+	});
+
+	return count;
+}
+
+std::string cpu_thread::get_stats_json()
+{
+	const u64 now = __rdtsc();
+
+	std::string result = fmt::format("{\n\t\"tsc\": %u,\n\t\"threads\": [", now);
+
+	bool first = true;
+
+	if (!for_all_cpu_locked([&](cpu_thread* cpu)
+	{
+		const u64 total = now - cpu->start_tsc;
+
+		u64 stalls = 0;
+
+		for (u64 ticks : cpu->stall_tsc)
+		{
+			stalls += ticks;
+		}
+
+		// Escape thread name (PPU thread names are set by the guest)
+		std::string name;
+
+		for (const char c : cpu->get_name())
+		{
+			if (c == '"' || c == '\\')
+			{
+				name += '\\';
+				name += c;
+			}
+			else if (static_cast<u8>(c) < 0x20)
+			{
+				fmt::append(name, "\\u%04x", static_cast<u8>(c));
+			}
+			else
+			{
+				name += c;
+			}
+		}
+
+		fmt::append(result, "%s\n\t\t{\"id\": %u, \"type\": \"%s\", \"name\": \"%s\", \"total\": %u, \"run\": %u, "
+			"\"suspend\": %u, \"pause\": %u, \"memory\": %u, \"channel\": %u}",
+			first ? "" : ",", cpu->id, cpu->id_type() == 1 ? "ppu" : "spu", name, total, total > stalls ? total - stalls : 0,
+			cpu->stall_tsc[static_cast<u32>(cpu_stall::suspend)].load(),
+			cpu->stall_tsc[static_cast<u32>(cpu_stall::pause)].load(),
+			cpu->stall_tsc[static_cast<u32>(cpu_stall::memory)].load(),
+			cpu->stall_tsc[static_cast<u32>(cpu_stall::channel)].load());
+
+		first = false;
+	}))
+	{
+		LOG_ERROR(GENERAL, "cpu_thread::get_stats_json(): too many concurrent accesses");
+	}
+
+	result += "\n\t]\n}\n";
+	return result;
+}
+
+void cpu_thread::quiesce(cpu_thread* _this) noexcept
+{
+	const u64 target = ++g_cpu_epoch;
+
+	if (_this)
+	{
+		_this->epoch.release(target);
+	}
+
+	const cpu_stall_scope stall(_this, cpu_stall::pause);
+
+	const u64 start = get_system_time();
+
+	while (true)
+	{
+		bool ok = true;
+
+		// Hold the reader lock so that threads can't be destroyed during the scan
+		if (!for_all_cpu_locked([&](cpu_thread* cpu)
+		{
+			// Waiting threads are outside of guest code, sleeping threads (lv2) ended their block with sc
+			if (cpu == _this || cpu->epoch >= target || cpu->state & (cpu_flag::wait + cpu_flag::suspend))
+			{
+				return;
+			}
+
+			ok = false;
+
+			if (!(cpu->state & cpu_flag::epoch))
+			{
+				cpu->state += cpu_flag::epoch;
+				cpu->notify();
+			}
+		}))
+		{
+			ok = false;
+		}
+
+		if (LIKELY(ok))
+		{
+			break;
+		}
+
+		if (get_system_time() - start > 1000000)
+		{
+			// Some thread doesn't pass check_state in time: stop all threads instead (they can't resume execution of a stale block)
+			LOG_WARNING(GENERAL, "cpu_thread::quiesce(): timeout (epoch %u), falling back to suspend_all", target);
+			suspend_all lock(_this);
+			break;
+		}
+
+		busy_wait(500);
+	}
+}
+
 cpu_thread::suspend_all::suspend_all(cpu_thread* _this) noexcept
 	: m_lock(g_cpu_array_lock.try_shared_lock())
 	, m_this(_this)
@@ -353,6 +570,9 @@ cpu_thread::suspend_all::suspend_all(cpu_thread* _this) noexcept
 
 	g_cpu_pause_ctr++;
 
+	// Time spent waiting for other threads
+	const cpu_stall_scope stall(m_this, cpu_stall::pause);
+
 	reader_lock lock(g_cpu_pause_lock);
 
 	for_all_cpu([](cpu_thread* cpu)
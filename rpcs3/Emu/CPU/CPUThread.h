@@ -22,9 +22,22 @@ enum class cpu_flag : u32
 	dbg_pause, // Thread paused
 	dbg_step, // Thread forced to pause after one step (one instruction, etc)
 
+	epoch, // Thread must publish quiescent state (passing through check_state)
+
 	__bitset_enum_max
 };
 
+// Thread stall categories for time accounting
+enum class cpu_stall : u32
+{
+	suspend, // Suspended by lv2 scheduler (cpu_flag::suspend)
+	pause, // Paused by suspend_all or debugger
+	memory, // Blocked in vm::passive_lock
+	channel, // Waiting on SPU channel or event
+
+	__max
+};
+
 class cpu_thread
 {
 	// PPU cache backward compatibility hack
@@ -44,6 +57,9 @@ public:
 	// Public thread state
 	atomic_bs_t<cpu_flag> state{cpu_flag::stop + cpu_flag::wait};
 
+	// Last observed global epoch (published in check_state)
+	atomic_t<u64> epoch{0};
+
 	// Process thread state, return true if the checker must return
 	bool check_state() noexcept;
 
@@ -85,6 +101,29 @@ public:
 	// Thread stats for external observation
 	static atomic_t<u64> g_threads_created, g_threads_deleted;
 
+	// TSC timestamp of thread registration
+	u64 start_tsc = 0;
+
+	// Accumulated TSC ticks spent in each stall category (written only by the thread itself, read by others)
+	atomic_t<u64> stall_tsc[static_cast<u32>(cpu_stall::__max)]{};
+
+	// Number of active cpu_stall_scope objects (only the outermost one is accounted)
+	u32 stall_depth = 0;
+
+	// Add stall ticks
+	void add_stall(cpu_stall type, u64 ticks) noexcept
+	{
+		// Single writer: no need for an atomic RMW, only the store must be atomic
+		auto& ctr = stall_tsc[static_cast<u32>(type)];
+		ctr.release(ctr.load() + ticks);
+	}
+
+	// Sum stall ticks of all registered threads (returns thread count, total lifetime ticks in *total)
+	static u32 get_stall_totals(u64 (&out)[static_cast<u32>(cpu_stall::__max)], u64* total = nullptr);
+
+	// Get machine-readable (JSON) snapshot of per-thread time accounting
+	static std::string get_stats_json();
+
 	// Get thread name
 	virtual std::string get_name() const = 0;
 
@@ -103,6 +142,9 @@ public:
 	// Callback for vm::temporary_unlock
 	virtual void cpu_unmem() {}
 
+	// Wait until all other threads pass a quiescent state (check_state, wait or lv2 sleep) without stopping them (falls back to suspend_all after 1s)
+	static void quiesce(cpu_thread* _this) noexcept;
+
 	// Thread locker
 	class suspend_all
 	{
@@ -125,5 +167,33 @@ inline cpu_thread* get_current_cpu_thread() noexcept
 	return g_tls_current_cpu_thread;
 }
 
+// Accounts time spent in the scope to the given stall category (nested scopes are accounted to the outermost one)
+class cpu_stall_scope
+{
+	cpu_thread* const m_cpu;
+	const cpu_stall m_type;
+	const u64 m_start;
+
+public:
+	cpu_stall_scope(cpu_thread* cpu, cpu_stall type) noexcept
+		: m_cpu(cpu)
+		, m_type(type)
+		, m_start(cpu && !cpu->stall_depth++ ? __rdtsc() : 0)
+	{
+	}
+
+	cpu_stall_scope(const cpu_stall_scope&) = delete;
+
+	cpu_stall_scope& operator=(const cpu_stall_scope&) = delete;
+
+	~cpu_stall_scope()
+	{
+		if (m_cpu && !--m_cpu->stall_depth)
+		{
+			m_cpu->add_stall(m_type, __rdtsc() - m_start);
+		}
+	}
+};
+
 class ppu_thread;
 class spu_thread;
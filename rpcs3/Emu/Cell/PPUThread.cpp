@@ -6,6 +6,7 @@
 #include "Emu/Memory/vm.h"
 #include "Emu/System.h"
 #include "Emu/IdManager.h"
+#include "Emu/CPU/CPUCompileScheduler.h"
 #include "PPUThread.h"
 #include "PPUInterpreter.h"
 #include "PPUAnalyser.h"
@@ -165,7 +166,7 @@ extern const ppu_decoder<ppu_interpreter_fast> g_ppu_interpreter_fast([](auto& t
 
 extern void ppu_initialize();
 extern void ppu_initialize(const ppu_module& info);
-static void ppu_initialize2(class jit_compiler& jit, const ppu_module& module_part, const std::string& cache_path, const std::string& obj_name);
+static void ppu_initialize2(class jit_compiler& jit, class jit_object_archive& jar, const ppu_module& module_part, const std::string& cache_path, const std::string& obj_name);
 extern void ppu_execute_syscall(ppu_thread& ppu, u64 code);
 
 // Get pointer to executable cache
@@ -175,6 +176,91 @@ static T& ppu_ref(u32 addr)
 	return *reinterpret_cast<T*>(vm::g_exec_addr + (u64)addr * 2);
 }
 
+// Incremented after the interpreter cache is modified (invalidates predecoded blocks)
+static atomic_t<u64> s_ppu_block_epoch{0};
+
+// Predecoded basic block (copy of interpreter cache values)
+struct ppu_block
+{
+	u32 addr = 0;
+	std::vector<u64> ops;
+};
+
+// Per-thread cache of predecoded basic blocks for the interpreter
+struct ppu_block_cache
+{
+	static constexpr u32 max_size = 256;
+
+	u64 epoch = 0;
+
+	// Direct-mapped lookup table
+	std::array<ppu_block*, 4096> table{};
+
+	std::unordered_map<u32, ppu_block> blocks;
+
+	const ppu_block& get(u32 addr)
+	{
+		if (const u64 current = s_ppu_block_epoch; UNLIKELY(epoch != current))
+		{
+			table.fill(nullptr);
+			blocks.clear();
+			epoch = current;
+		}
+
+		auto& slot = table[addr / 4 % table.size()];
+
+		if (LIKELY(slot && slot->addr == addr))
+		{
+			return *slot;
+		}
+
+		auto& block = blocks[addr];
+
+		if (block.ops.empty())
+		{
+			block.addr = addr;
+
+			for (u32 pos = addr; block.ops.size() < max_size; pos += 4)
+			{
+				// Don't cross the commit granularity of the executable cache
+				if (pos != addr && pos % 2048 == 0)
+				{
+					break;
+				}
+
+				const u64 value = ppu_ref(pos);
+				block.ops.emplace_back(value);
+
+				// Stop after branches and sc (primary opcodes 16..19)
+				if (const u32 opcd = static_cast<u32>(value >> 58); opcd >= 16 && opcd <= 19)
+				{
+					break;
+				}
+			}
+		}
+
+		slot = &block;
+		return block;
+	}
+
+	// Update the instruction in all cached blocks containing it (blocks don't cross 2048-byte boundary)
+	void refresh(u32 addr, u64 value)
+	{
+		for (u32 pos = addr;; pos -= 4)
+		{
+			if (const auto found = blocks.find(pos); found != blocks.end() && (addr - pos) / 4 < found->second.ops.size())
+			{
+				found->second.ops[(addr - pos) / 4] = value;
+			}
+
+			if (pos % 2048 == 0 || addr - pos >= (max_size - 1) * 4)
+			{
+				break;
+			}
+		}
+	}
+};
+
 // Get interpreter cache value
 static u64 ppu_cache(u32 addr)
 {
@@ -195,7 +281,14 @@ static bool ppu_fallback(ppu_thread& ppu, ppu_opcode_t op)
 		LOG_ERROR(PPU, "Unregistered instruction: 0x%08x", op.opcode);
 	}
 
-	ppu_ref(ppu.cia) = ppu_cache(ppu.cia);
+	const u64 value = ppu_cache(ppu.cia);
+	ppu_ref(ppu.cia) = value;
+
+	// Other threads update their blocks when they reach this instruction
+	if (ppu.block_cache)
+	{
+		ppu.block_cache->refresh(ppu.cia, value);
+	}
 
 	return false;
 }
@@ -282,6 +375,8 @@ extern void ppu_register_range(u32 addr, u32 size)
 		addr += 4;
 		size -= 4;
 	}
+
+	s_ppu_block_epoch++;
 }
 
 extern void ppu_register_function_at(u32 addr, u32 size, ppu_function_t ptr)
@@ -290,6 +385,7 @@ extern void ppu_register_function_at(u32 addr, u32 size, ppu_function_t ptr)
 	if (ptr)
 	{
 		ppu_ref<u32>(addr) = ::narrow<u32>(reinterpret_cast<std::uintptr_t>(ptr));
+		s_ppu_block_epoch++;
 		return;
 	}
 
@@ -321,6 +417,8 @@ extern void ppu_register_function_at(u32 addr, u32 size, ppu_function_t ptr)
 		addr += 4;
 		size -= 4;
 	}
+
+	s_ppu_block_epoch++;
 }
 
 // Breakpoint entry point
@@ -365,6 +463,9 @@ extern void ppu_breakpoint(u32 addr, bool isAdding)
 		// Remove breakpoint
 		ppu_ref(addr) = ppu_cache(addr);
 	}
+
+	s_ppu_block_epoch++;
+	cpu_thread::quiesce(get_current_cpu_thread());
 }
 
 //sets breakpoint, does nothing if there is a breakpoint there already
@@ -380,6 +481,7 @@ extern void ppu_set_breakpoint(u32 addr)
 	if (ppu_ref<u32>(addr) != _break)
 	{
 		ppu_ref<u32>(addr) = _break;
+		s_ppu_block_epoch++;
 	}
 }
 
@@ -396,6 +498,7 @@ extern void ppu_remove_breakpoint(u32 addr)
 	if (ppu_ref<u32>(addr) == _break)
 	{
 		ppu_ref(addr) = ppu_cache(addr);
+		s_ppu_block_epoch++;
 	}
 }
 
@@ -426,6 +529,10 @@ extern bool ppu_patch(u32 addr, u32 value)
 		ppu_ref(addr) = ppu_cache(addr);
 	}
 
+	s_ppu_block_epoch++;
+
+	// Make sure no thread still executes a block decoded before the patch
+	cpu_thread::quiesce(get_current_cpu_thread());
 	return true;
 }
 
@@ -629,9 +736,15 @@ void ppu_thread::exec_task()
 		return;
 	}
 
-	const auto cache = vm::g_exec_addr;
 	using func_t = decltype(&ppu_interpreter::UNK);
 
+	if (!block_cache)
+	{
+		block_cache = std::make_unique<ppu_block_cache>();
+	}
+
+	auto& blocks = *block_cache;
+
 	while (true)
 	{
 		const auto exec_op = [this](u64 op)
@@ -639,63 +752,31 @@ void ppu_thread::exec_task()
 			return reinterpret_cast<func_t>((uptr)(u32)op)(*this, {u32(op >> 32)});
 		};
 
-		if (cia % 8 || !s_use_ssse3 || UNLIKELY(state))
+		if (UNLIKELY(state))
 		{
 			if (test_stopped()) return;
 
 			// Decode single instruction (may be step)
-			if (exec_op(*reinterpret_cast<u64*>(cache + (u64)cia * 2))) { cia += 4; }
+			if (exec_op(ppu_ref(cia))) { cia += 4; }
 			continue;
 		}
 
-		u64 op0, op1, op2, op3;
-		u64 _pos = (u64)cia * 2;
+		const auto& block = blocks.get(cia);
 
-		// Reinitialize
+		// The block may be invalidated by the last instruction (sc can reenter the interpreter), so it's not accessed after that
+		for (auto ptr = block.ops.data(), end = ptr + block.ops.size();;)
 		{
-			const v128 _op0 = *reinterpret_cast<const v128*>(cache + _pos);
-			const v128 _op1 = *reinterpret_cast<const v128*>(cache + _pos + 16);
-			op0 = _op0._u64[0];
-			op1 = _op0._u64[1];
-			op2 = _op1._u64[0];
-			op3 = _op1._u64[1];
-		}
+			if (UNLIKELY(!exec_op(*ptr)))
+			{
+				break;
+			}
 
-		while (LIKELY(exec_op(op0)))
-		{
 			cia += 4;
 
-			if (LIKELY(exec_op(op1)))
+			if (++ptr == end)
 			{
-				cia += 4;
-
-				if (LIKELY(exec_op(op2)))
-				{
-					cia += 4;
-
-					if (LIKELY(exec_op(op3)))
-					{
-						cia += 4;
-
-						if (UNLIKELY(state))
-						{
-							break;
-						}
-
-						_pos += 32;
-						const v128 _op0 = *reinterpret_cast<const v128*>(cache + _pos);
-						const v128 _op1 = *reinterpret_cast<const v128*>(cache + _pos + 16);
-						op0 = _op0._u64[0];
-						op1 = _op0._u64[1];
-						op2 = _op1._u64[0];
-						op3 = _op1._u64[1];
-						continue;
-					}
-					break;
-				}
 				break;
 			}
-			break;
 		}
 	}
 }
@@ -1148,26 +1229,25 @@ extern bool ppu_stwcx(ppu_thread& ppu, u32 addr, u32 reg_value)
 		return false;
 	}
 
-	vm::passive_unlock(ppu);
-
-	auto& res = vm::reservation_lock(addr, sizeof(u32));
-	const u64 old_time = res.load() & -128;
+	auto& res = vm::reservation_acquire(addr, sizeof(u32));
 
-	const bool result = ppu.rtime == old_time && data.compare_and_swap_test(old_data, reg_value);
+	ppu.raddr = 0;
 
-	if (result)
+	// Lock the reservation only if its timestamp is unchanged (never wait: concurrent writer would invalidate it anyway)
+	if (!res.compare_and_swap_test(ppu.rtime, ppu.rtime + 1))
 	{
-		res.release(old_time + 128);
-		vm::reservation_notifier(addr, sizeof(u32)).notify_all();
+		return false;
 	}
-	else
+
+	if (data.compare_and_swap_test(old_data, reg_value))
 	{
-		res.release(old_time);
+		res.release(ppu.rtime + 128);
+		vm::reservation_notifier(addr, sizeof(u32)).notify_all();
+		return true;
 	}
 
-	vm::passive_lock(ppu);
-	ppu.raddr = 0;
-	return result;
+	res.release(ppu.rtime);
+	return false;
 }
 
 const auto ppu_stdcx_tx = build_function_asm<u32(*)(u32 raddr, u64 rtime, u64 rdata, u64 value)>([](asmjit::X86Assembler& c, auto& args)
@@ -1269,26 +1349,25 @@ extern bool ppu_stdcx(ppu_thread& ppu, u32 addr, u64 reg_value)
 		return false;
 	}
 
-	vm::passive_unlock(ppu);
+	auto& res = vm::reservation_acquire(addr, sizeof(u64));
 
-	auto& res = vm::reservation_lock(addr, sizeof(u64));
-	const u64 old_time = res.load() & -128;
-
-	const bool result = ppu.rtime == old_time && data.compare_and_swap_test(old_data, reg_value);
+	ppu.raddr = 0;
 
-	if (result)
+	// Lock the reservation only if its timestamp is unchanged (never wait: concurrent writer would invalidate it anyway)
+	if (!res.compare_and_swap_test(ppu.rtime, ppu.rtime + 1))
 	{
-		res.release(old_time + 128);
-		vm::reservation_notifier(addr, sizeof(u64)).notify_all();
+		return false;
 	}
-	else
+
+	if (data.compare_and_swap_test(old_data, reg_value))
 	{
-		res.release(old_time);
+		res.release(ppu.rtime + 128);
+		vm::reservation_notifier(addr, sizeof(u64)).notify_all();
+		return true;
 	}
 
-	vm::passive_lock(ppu);
-	ppu.raddr = 0;
-	return result;
+	res.release(ppu.rtime);
+	return false;
 }
 
 extern void ppu_initialize()
@@ -1305,6 +1384,12 @@ extern void ppu_initialize()
 		return;
 	}
 
+	// Build SPU cache concurrently (its jobs have the lowest priority)
+	named_thread spu_worker("SPU Cache Builder", []()
+	{
+		spu_cache::initialize();
+	});
+
 	// Initialize main module
 	ppu_initialize(*_main);
 
@@ -1321,8 +1406,8 @@ extern void ppu_initialize()
 		ppu_initialize(*ptr);
 	}
 
-	// Initialize SPU cache
-	spu_cache::initialize();
+	// Wait for SPU cache
+	spu_worker();
 }
 
 extern void ppu_initialize(const ppu_module& info)
@@ -1346,6 +1431,7 @@ extern void ppu_initialize(const ppu_module& info)
 			}
 		}
 
+		s_ppu_block_epoch++;
 		return;
 	}
 
@@ -1431,32 +1517,25 @@ extern void ppu_initialize(const ppu_module& info)
 		std::vector<ppu_function_t> funcs;
 	};
 
-	struct jit_core_allocator
-	{
-		::semaphore<0x7fffffff> sem;
-
-		jit_core_allocator(s32 arg)
-			: sem(arg)
-		{
-		}
-	};
-
 	// Permanently loaded compiled PPU modules (name -> data)
 	jit_module& jit_mod = fxm::get_always<std::unordered_map<std::string, jit_module>>()->emplace(cache_path + info.name, jit_module{}).first->second;
 
 	// Compiler instance (deferred initialization)
 	std::shared_ptr<jit_compiler> jit;
 
+	// Object archive of the module (replaces separate object files)
+	jit_object_archive jar(cache_path + "v3-tane.jar");
+	jar.migrate(cache_path);
+
 	// Compiler mutex (global)
 	static shared_mutex jmutex;
 
-	// Initialize global semaphore with the max number of threads
-	u32 max_threads = static_cast<u32>(g_cfg.core.llvm_threads);
-	s32 thread_count = max_threads > 0 ? std::min(max_threads, std::thread::hardware_concurrency()) : std::thread::hardware_concurrency();
-	const auto jcores = fxm::get_always<jit_core_allocator>(std::max<s32>(thread_count, 1));
+	// Shared compiler threads (the main executable is compiled before PRX modules)
+	const auto jsched = fxm::get_always<compile_scheduler>();
+	const auto jprio = info.name.empty() ? compile_priority::ppu_main : compile_priority::ppu_prx;
 
-	// Worker threads
-	std::vector<std::thread> jthreads;
+	// Compilation jobs of this module
+	compile_scheduler::group jobs;
 
 	// Global variables to initialize
 	std::vector<std::pair<std::string, u64>> globals;
@@ -1617,7 +1696,7 @@ extern void ppu_initialize(const ppu_module& info)
 		}
 
 		// Check object file
-		if (fs::is_file(cache_path + obj_name))
+		if (jar.has(obj_name))
 		{
 			if (!jit)
 			{
@@ -1626,55 +1705,48 @@ extern void ppu_initialize(const ppu_module& info)
 			}
 
 			std::lock_guard lock(jmutex);
-			jit->add(cache_path + obj_name);
 
-			LOG_SUCCESS(PPU, "LLVM: Loaded module %s", obj_name);
-			continue;
+			if (jit->add(obj_name, jar))
+			{
+				LOG_SUCCESS(PPU, "LLVM: Loaded module %s", obj_name);
+				continue;
+			}
+
+			// Damaged object is compiled again
 		}
 
 		// Update progress dialog
 		g_progr_ptotal++;
 
-		// Create worker thread for compilation
-		jthreads.emplace_back([&jit, obj_name = obj_name, part = std::move(part), &cache_path, jcores]()
+		// Queue compilation job
+		jsched->push(jprio, jobs, [&jit, &jar, obj_name = obj_name, part = std::move(part), &cache_path]()
 		{
-			// Set low priority
-			thread_ctrl::set_native_priority(-1);
-
-			// Allocate "core"
+			if (!Emu.IsStopped())
 			{
-				std::lock_guard jlock(jcores->sem);
+				LOG_WARNING(PPU, "LLVM: Compiling module %s%s", cache_path, obj_name);
 
-				if (!Emu.IsStopped())
-				{
-					LOG_WARNING(PPU, "LLVM: Compiling module %s%s", cache_path, obj_name);
-
-					// Use another JIT instance
-					jit_compiler jit2({}, g_cfg.core.llvm_cpu, 0x1);
-					ppu_initialize2(jit2, part, cache_path, obj_name);
-				}
-
-				g_progr_pdone++;
+				// Use another JIT instance
+				jit_compiler jit2({}, g_cfg.core.llvm_cpu, 0x1);
+				ppu_initialize2(jit2, jar, part, cache_path, obj_name);
 			}
 
-			if (Emu.IsStopped() || !jit || !fs::is_file(cache_path + obj_name))
+			g_progr_pdone++;
+
+			if (Emu.IsStopped() || !jit || !jar.has(obj_name))
 			{
 				return;
 			}
 
 			// Proceed with original JIT instance
 			std::lock_guard lock(jmutex);
-			jit->add(cache_path + obj_name);
+			jit->add(obj_name, jar);
 
 			LOG_SUCCESS(PPU, "LLVM: Compiled module %s", obj_name);
 		});
 	}
 
-	// Join worker threads
-	for (auto& thread : jthreads)
-	{
-		thread.join();
-	}
+	// Wait for compilation jobs
+	jsched->wait(jobs);
 
 	if (Emu.IsStopped() || !get_current_cpu_thread())
 	{
@@ -1753,7 +1825,7 @@ extern void ppu_initialize(const ppu_module& info)
 #endif
 }
 
-static void ppu_initialize2(jit_compiler& jit, const ppu_module& module_part, const std::string& cache_path, const std::string& obj_name)
+static void ppu_initialize2(jit_compiler& jit, jit_object_archive& jar, const ppu_module& module_part, const std::string& cache_path, const std::string& obj_name)
 {
 #ifdef LLVM_AVAILABLE
 	using namespace llvm;
@@ -1860,6 +1932,6 @@ static void ppu_initialize2(jit_compiler& jit, const ppu_module& module_part, co
 	}
 
 	// Load or compile module
-	jit.add(std::move(module), cache_path);
+	jit.add(std::move(module), jar);
 #endif // LLVM_AVAILABLE
 }
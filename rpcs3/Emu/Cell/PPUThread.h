@@ -35,6 +35,8 @@ struct ppu_thread_params
 	u64 arg1;
 };
 
+struct ppu_block_cache;
+
 class ppu_thread : public cpu_thread
 {
 public:
@@ -181,6 +183,8 @@ public:
 	u64 start_time{0}; // Sleep start timepoint
 	const char* last_function{}; // Last function name for diagnosis, optimized for speed.
 
+	std::unique_ptr<ppu_block_cache> block_cache; // Predecoded basic blocks (interpreter)
+
 	lf_value<std::string> ppu_name; // Thread name
 
 	be_t<u64>* get_stack_arg(s32 i, u64 align = alignof(u64));
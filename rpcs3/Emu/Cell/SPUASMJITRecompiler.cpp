@@ -724,6 +724,13 @@ spu_function_t spu_recompiler::compile(u64 last_reset_count, const std::vector<u
 	// Acknowledge success and add statistics
 	c->add(SPU_OFF_64(block_counter), ::size32(words) / (words_align / 4));
 
+	if (u64* const hits = m_spurt->make_counter(fn_location))
+	{
+		// Count function entries (JIT eviction)
+		c->mov(x86::rax, imm_ptr(hits));
+		c->inc(x86::qword_ptr(x86::rax));
+	}
+
 	if (m_pos != start)
 	{
 		// Jump to the entry point if necessary
@@ -864,11 +871,20 @@ spu_function_t spu_recompiler::compile(u64 last_reset_count, const std::vector<u
 		LOG_FATAL(SPU, "Failed to build a function");
 	}
 
-	if (!m_spurt->add(last_reset_count, fn_location, fn))
+	// ASMJIT is the first tier if LLVM is selected
+	const bool tier0 = g_cfg.core.spu_decoder == spu_decoder_type::llvm;
+
+	if (!m_spurt->add(last_reset_count, fn_location, fn, tier0))
 	{
 		return nullptr;
 	}
 
+	if (tier0 && !Emu.IsStopped())
+	{
+		// Queue recompilation with LLVM
+		fxm::get_always<spu_llvm_tier>()->push(last_reset_count, func);
+	}
+
 	if (g_cfg.core.spu_debug)
 	{
 		// Add ASMJIT logs
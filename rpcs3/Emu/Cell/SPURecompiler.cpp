@@ -12,6 +12,7 @@
 #include "SPUInterpreter.h"
 #include "SPUDisAsm.h"
 #include "SPURecompiler.h"
+#include "Emu/CPU/CPUCompileScheduler.h"
 #include <algorithm>
 #include <mutex>
 #include <thread>
@@ -306,10 +307,11 @@ void spu_cache::initialize()
 	atomic_t<std::size_t> fnext{};
 	atomic_t<u8> fail_flag{0};
 
+	// Shared compiler threads
+	const auto jsched = fxm::get_always<compile_scheduler>();
+
 	// Initialize compiler instances for parallel compilation
-	u32 max_threads = static_cast<u32>(g_cfg.core.llvm_threads);
-	u32 thread_count = max_threads > 0 ? std::min(max_threads, std::thread::hardware_concurrency()) : std::thread::hardware_concurrency();
-	std::vector<std::unique_ptr<spu_recompiler_base>> compilers{thread_count};
+	std::vector<std::unique_ptr<spu_recompiler_base>> compilers{jsched->size()};
 
 	if (g_cfg.core.spu_decoder == spu_decoder_type::fast)
 	{
@@ -346,19 +348,19 @@ void spu_cache::initialize()
 
 	if (compilers.size() && !func_list.empty())
 	{
-		// Initialize progress dialog (wait for previous progress done)
-		while (g_progr_ptotal)
+		// Initialize progress dialog (may be shared with PPU compilation)
+		if (!g_progr_ptotal)
 		{
-			std::this_thread::sleep_for(5ms);
+			g_progr = "Building SPU cache...";
 		}
 
-		g_progr = "Building SPU cache...";
 		g_progr_ptotal += func_list.size();
 	}
 
-	std::deque<named_thread<std::function<void()>>> thread_queue;
+	// Compilation jobs (one per compiler instance)
+	compile_scheduler::group jobs;
 
-	for (std::size_t i = 0; i < compilers.size(); i++) thread_queue.emplace_back("Worker " + std::to_string(i), [&, compiler = compilers[i].get()]()
+	std::function<void(spu_recompiler_base*)> build = [&](spu_recompiler_base* compiler)
 	{
 		// Register SPU runtime user
 		spu_runtime::passive_lock _passive_lock(compiler->get_runtime());
@@ -367,8 +369,26 @@ void spu_cache::initialize()
 		std::vector<be_t<u32>> ls(0x10000);
 
 		// Build functions
-		for (std::size_t func_i = fnext++; func_i < func_list.size(); func_i = fnext++)
+		while (fnext < func_list.size())
 		{
+			// Yield to PPU compilation, continue later
+			if (jsched->preempted(compile_priority::spu_cache))
+			{
+				jsched->push(compile_priority::spu_cache, jobs, [&build, compiler]()
+				{
+					build(compiler);
+				});
+
+				return;
+			}
+
+			const std::size_t func_i = fnext++;
+
+			if (func_i >= func_list.size())
+			{
+				break;
+			}
+
 			std::vector<u32>& func = func_list[func_i];
 
 			if (Emu.IsStopped() || fail_flag)
@@ -419,14 +439,19 @@ void spu_cache::initialize()
 
 			g_progr_pdone++;
 		}
-	});
+	};
 
-	// Join all threads
-	while (!thread_queue.empty())
+	for (auto& compiler : compilers)
 	{
-		thread_queue.pop_front();
+		jsched->push(compile_priority::spu_cache, jobs, [&build, compiler = compiler.get()]()
+		{
+			build(compiler);
+		});
 	}
 
+	// Wait for all jobs
+	jsched->wait(jobs);
+
 	if (Emu.IsStopped())
 	{
 		LOG_ERROR(SPU, "SPU Runtime: Cache building aborted.");
@@ -453,6 +478,137 @@ void spu_cache::initialize()
 	});
 }
 
+spu_profile::spu_profile()
+{
+	const std::string ppu_cache = Emu.PPUCache();
+
+	if (ppu_cache.empty())
+	{
+		return;
+	}
+
+	m_path = ppu_cache + "spu-v1-prof.dat";
+
+	const fs::file file(m_path);
+
+	if (!file)
+	{
+		return;
+	}
+
+	// Read the whole profile: [name size, name, counter count, counters...]
+	while (true)
+	{
+		be_t<u32> name_size;
+		be_t<u32> size;
+		std::string name;
+		std::vector<u64> data;
+
+		if (!file.read(name_size))
+		{
+			break;
+		}
+
+		name.resize(name_size);
+
+		if (file.read(name.data(), name.size()) != name.size() || !file.read(size))
+		{
+			LOG_ERROR(SPU, "Truncated SPU profile: %s", m_path);
+			break;
+		}
+
+		data.resize(size);
+
+		if (file.read(data.data(), data.size() * sizeof(u64)) != data.size() * sizeof(u64))
+		{
+			LOG_ERROR(SPU, "Truncated SPU profile: %s", m_path);
+			break;
+		}
+
+		m_map.emplace(std::move(name), std::move(data));
+	}
+
+	LOG_NOTICE(SPU, "Loaded SPU profile (%u functions)", m_map.size());
+}
+
+spu_profile::~spu_profile()
+{
+	if (g_cfg.core.spu_profiling)
+	{
+		save();
+	}
+}
+
+u64* spu_profile::get(const std::string& name, u32 size)
+{
+	std::lock_guard lock(m_mutex);
+
+	auto& data = m_map[name];
+
+	if (data.size() != size)
+	{
+		if (m_used.count(name))
+		{
+			// Counters are already used by compiled code, allocate separate slot (not saved)
+			return m_unsaved.emplace_back(size).data();
+		}
+
+		// Reset mismatching or new entry
+		data.clear();
+		data.resize(size);
+	}
+
+	m_used.emplace(name);
+	return data.data();
+}
+
+std::vector<u64> spu_profile::snapshot(const std::string& name) const
+{
+	reader_lock lock(m_mutex);
+
+	const auto found = m_map.find(name);
+
+	if (found == m_map.end())
+	{
+		return {};
+	}
+
+	return found->second;
+}
+
+void spu_profile::save() const
+{
+	if (m_path.empty())
+	{
+		return;
+	}
+
+	std::string data;
+	{
+		reader_lock lock(m_mutex);
+
+		for (const auto& [name, counters] : m_map)
+		{
+			const be_t<u32> name_size = ::size32(name);
+			const be_t<u32> size = ::size32(counters);
+			data.append(reinterpret_cast<const char*>(&name_size), sizeof(name_size));
+			data.append(name);
+			data.append(reinterpret_cast<const char*>(&size), sizeof(size));
+			data.append(reinterpret_cast<const char*>(counters.data()), counters.size() * sizeof(u64));
+		}
+	}
+
+	fs::file file(m_path, fs::rewrite);
+
+	if (!file)
+	{
+		LOG_ERROR(SPU, "Failed to save SPU profile: %s (%s)", m_path, fs::g_tls_error);
+		return;
+	}
+
+	file.write(data);
+}
+
 bool spu_runtime::func_compare::operator()(const std::vector<u32>& lhs, const std::vector<u32>& rhs) const
 {
 	if (lhs.empty())
@@ -516,10 +672,13 @@ spu_runtime::spu_runtime()
 		fs::file(m_cache_path + "spu-ir.log", fs::rewrite);
 	}
 
+	// JIT memory budget only accounts for SPU functions
+	m_jit_base = jit_runtime::usage();
+
 	LOG_SUCCESS(SPU, "SPU Recompiler Runtime initialized...");
 }
 
-bool spu_runtime::add(u64 last_reset_count, void* _where, spu_function_t compiled)
+bool spu_runtime::add(u64 last_reset_count, void* _where, spu_function_t compiled, bool tier0)
 {
 	writer_lock lock(*this);
 
@@ -538,12 +697,20 @@ bool spu_runtime::add(u64 last_reset_count, void* _where, spu_function_t compile
 	//
 	const u32 _off = 1 + (func[0] / 4) * (false);
 
-	// Set pointer to the compiled function
+	// Set pointer to the compiled function (replaces the first tier function if promoted)
 	where.second = compiled;
 
+	if (tier0)
+	{
+		m_tier0.emplace(&where);
+	}
+
 	// Register function in PIC map
 	m_pic_map[{func.data() + _off, func.size() - _off}] = compiled;
 
+	// Register function at its own address for lock-free lookup
+	lookup_add(func[0], {func.data() + 1, func.size() - 1}, compiled);
+
 	// Prepare sorted list
 	m_flat_list.clear();
 	m_flat_list.assign(m_pic_map.cbegin(), m_pic_map.cend());
@@ -854,12 +1021,18 @@ bool spu_runtime::add(u64 last_reset_count, void* _where, spu_function_t compile
 		g_dispatcher[0] = reinterpret_cast<spu_function_t>(reinterpret_cast<u64>(wxptr));
 	}
 
+	// Check JIT memory budget
+	if (const u64 budget = g_cfg.core.spu_jit_budget * u64{1 << 20}; budget && jit_runtime::usage() - m_jit_base > budget)
+	{
+		m_evict = true;
+	}
+
 	// Notify in lock destructor
 	lock.notify = true;
 	return true;
 }
 
-void* spu_runtime::find(u64 last_reset_count, const std::vector<u32>& func)
+void* spu_runtime::find(u64 last_reset_count, const std::vector<u32>& func, bool promote)
 {
 	writer_lock lock(*this);
 
@@ -869,6 +1042,19 @@ void* spu_runtime::find(u64 last_reset_count, const std::vector<u32>& func)
 		return nullptr;
 	}
 
+	if (promote)
+	{
+		const auto found = m_map.find(func);
+
+		if (found == m_map.end() || !m_tier0.erase(&*found))
+		{
+			// Not registered or already promoted
+			return g_dispatcher;
+		}
+
+		return &*found;
+	}
+
 	//
 	const u32 _off = 1 + (func[0] / 4) * (false);
 
@@ -927,10 +1113,129 @@ void* spu_runtime::find(u64 last_reset_count, const std::vector<u32>& func)
 	return fn_location;
 }
 
+static inline u32 spu_lookup_hash(u32 addr, u32 first)
+{
+	return static_cast<u32>(((u64{addr} << 32 | first) * 0x9e3779b97f4a7c15) >> 32);
+}
+
+void spu_runtime::lookup_add(u32 addr, std::basic_string_view<u32> data, spu_function_t func)
+{
+	if (data.empty())
+	{
+		return;
+	}
+
+	auto table = const_cast<lookup_table*>(m_lookup.load());
+
+	if (!table || table->count >= table->mask / 2)
+	{
+		// Allocate bigger table and copy the entries (old table remains readable)
+		const u32 size = table ? (table->mask + 1) * 2 : 1024;
+
+		auto& _new = m_lookup_tables.emplace_back(std::make_unique<lookup_table>());
+		_new->mask = size - 1;
+		_new->count = 0;
+		_new->slots = std::make_unique<atomic_t<const lookup_entry*>[]>(size);
+
+		if (table)
+		{
+			for (u32 i = 0; i <= table->mask; i++)
+			{
+				if (const auto entry = table->slots[i].load())
+				{
+					for (u32 pos = spu_lookup_hash(entry->addr, entry->data[0]);; pos++)
+					{
+						if (!_new->slots[pos & _new->mask].raw())
+						{
+							_new->slots[pos & _new->mask].raw() = entry;
+							_new->count++;
+							break;
+						}
+					}
+				}
+			}
+		}
+
+		table = _new.get();
+		m_lookup.release(table);
+	}
+
+	const auto& entry = m_lookup_entries.emplace_back(lookup_entry{addr, func, data});
+
+	for (u32 pos = spu_lookup_hash(addr, data[0]);; pos++)
+	{
+		auto& slot = table->slots[pos & table->mask];
+
+		if (const auto old = slot.load())
+		{
+			if (old->addr == addr && old->data == data)
+			{
+				// Replace the function (e.g. promoted)
+				slot.release(&entry);
+				return;
+			}
+
+			continue;
+		}
+
+		slot.release(&entry);
+		table->count++;
+		return;
+	}
+}
+
+spu_function_t spu_runtime::lookup_find(const u32* ls, u32 addr) const
+{
+	const auto table = m_lookup.load();
+
+	if (!table)
+	{
+		return nullptr;
+	}
+
+	const u32 first = ls[addr / 4];
+
+	// Select the longest matching function
+	const lookup_entry* result = nullptr;
+
+	for (u32 pos = spu_lookup_hash(addr, first);; pos++)
+	{
+		const auto entry = table->slots[pos & table->mask].load();
+
+		if (!entry)
+		{
+			break;
+		}
+
+		if (entry->addr != addr || entry->data[0] != first || (result && result->data.size() >= entry->data.size()))
+		{
+			continue;
+		}
+
+		if (entry->data.size() <= (0x40000 - addr) / 4 && entry->data.compare(0, entry->data.size(), ls + addr / 4, entry->data.size()) == 0)
+		{
+			result = entry;
+		}
+	}
+
+	return result ? result->func : nullptr;
+}
+
 spu_function_t spu_runtime::find(const u32* ls, u32 addr) const
 {
 	const u64 reset_count = m_reset_count;
 
+	// Fast path: function compiled at this address
+	if (const auto func = lookup_find(ls, addr))
+	{
+		if (reset_count == m_reset_count)
+		{
+			return func;
+		}
+
+		return nullptr;
+	}
+
 	reader_lock lock(*this);
 
 	if (reset_count != m_reset_count)
@@ -1004,56 +1309,316 @@ u64 spu_runtime::reset(std::size_t last_reset_count)
 		}
 	});
 
+	// Unpublish lookup table (readers may still access it, entries point to m_map keys)
+	m_lookup.release(nullptr);
+
+	// Wait for threads to catch on jit_return flag
+	while (m_passive_locks)
+	{
+		busy_wait();
+	}
+
+	// Free lookup tables, no reader exists at this point
+	m_lookup_tables.clear();
+	m_lookup_entries.clear();
+
 	// Reset function map (may take some time)
 	m_map.clear();
 	m_pic_map.clear();
+	m_tier0.clear();
 
-	// Wait for threads to catch on jit_return flag
-	while (m_passive_locks)
+	// Free entry counters
+	m_hits.clear();
+	m_hit_counters.clear();
+
+	// Reinitialize (TODO)
+	jit_runtime::finalize();
+	jit_runtime::initialize();
+	m_jit_base = jit_runtime::usage();
+	m_evict = false;
+	return ++m_reset_count;
+}
+
+u64* spu_runtime::make_counter(void* where)
+{
+	if (!g_cfg.core.spu_jit_budget)
+	{
+		return nullptr;
+	}
+
+	writer_lock lock(*this);
+
+	auto& ctr = m_hits[where];
+
+	if (!ctr)
+	{
+		ctr = &m_hit_counters.emplace_back(0);
+	}
+
+	return ctr;
+}
+
+u64 spu_runtime::evict(u64 last_reset_count, std::vector<std::vector<u32>>& hot)
+{
+	hot.clear();
+
+	{
+		reader_lock lock(*this);
+
+		if (last_reset_count != m_reset_count)
+		{
+			return m_reset_count;
+		}
+
+		// Collect used functions
+		std::vector<std::pair<u64, const std::vector<u32>*>> used;
+
+		for (const auto& [where, ctr] : m_hits)
+		{
+			if (const u64 count = *ctr)
+			{
+				used.emplace_back(count, &static_cast<const decltype(m_map)::value_type*>(where)->first);
+			}
+		}
+
+		// Keep the most used quarter of all functions, the rest is evicted
+		const std::size_t keep = std::min(used.size(), m_map.size() / 4);
+
+		std::partial_sort(used.begin(), used.begin() + keep, used.end(), [](const auto& a, const auto& b)
+		{
+			return a.first > b.first;
+		});
+
+		for (std::size_t i = 0; i < keep; i++)
+		{
+			hot.emplace_back(*used[i].second);
+		}
+
+		LOG_WARNING(SPU, "SPU Runtime: Evicting %u of %u functions (JIT memory: 0x%x)", m_map.size() - keep, m_map.size(), jit_runtime::usage());
+	}
+
+	return reset(last_reset_count);
+}
+
+void spu_runtime::handle_return(spu_thread* _spu)
+{
+	// Wait until the runtime becomes available
+	writer_lock lock(*this);
+
+	// Reset stack mirror
+	std::memset(_spu->stack_mirror.data(), 0xff, sizeof(spu_thread::stack_mirror));
+
+	// Reset the flag
+	_spu->state -= cpu_flag::jit_return;
+}
+
+spu_recompiler_base::spu_recompiler_base()
+{
+	result.reserve(8192);
+}
+
+spu_recompiler_base::~spu_recompiler_base()
+{
+}
+
+void spu_recompiler_base::make_function(const std::vector<u32>& data)
+{
+	for (u64 reset_count = m_spurt->get_reset_count();;)
+	{
+		if (LIKELY(compile(reset_count, data)))
+		{
+			if (LIKELY(!m_spurt->evict_pending()))
+			{
+				break;
+			}
+		}
+		else if (!g_cfg.core.spu_jit_budget)
+		{
+			reset_count = m_spurt->reset(reset_count);
+			continue;
+		}
+
+		// Free JIT memory, compile the requested function and relocate the most used functions in background
+		std::vector<std::vector<u32>> hot;
+		reset_count = m_spurt->evict(reset_count, hot);
+
+		if (m_spurt->get_reset_count() != reset_count || compile(reset_count, data))
+		{
+			relocate(reset_count, std::move(hot));
+			break;
+		}
+	}
+}
+
+// Background recompilation of functions kept after eviction
+struct spu_relocation
+{
+	// Owned by the job (must outlive it)
+	compile_scheduler::group jobs;
+
+	std::vector<std::vector<u32>> funcs;
+	std::size_t next = 0;
+
+	std::unique_ptr<spu_recompiler_base> compiler;
+	bool initialized = false;
+
+	u64 reset_count = 0;
+
+	static void run(const std::shared_ptr<spu_relocation>& _this)
+	{
+		const auto jsched = fxm::get_always<compile_scheduler>();
+
+		auto& compiler = *_this->compiler;
+
+		if (!_this->initialized)
+		{
+			// Initialize on the compiler thread
+			compiler.init();
+			_this->initialized = true;
+		}
+
+		// Fake LS
+		std::vector<be_t<u32>> ls(0x10000);
+
+		for (; _this->next < _this->funcs.size(); _this->next++)
+		{
+			// Register SPU runtime user (per function, reset() waits for it)
+			spu_runtime::passive_lock _passive_lock(compiler.get_runtime());
+
+			// Stop if the runtime has been reset meanwhile
+			if (Emu.IsStopped() || compiler.get_runtime().get_reset_count() != _this->reset_count || compiler.get_runtime().evict_pending())
+			{
+				return;
+			}
+
+			// Yield to any other compilation, continue later
+			if (jsched->preempted(compile_priority::spu_relocate))
+			{
+				jsched->push(compile_priority::spu_relocate, _this->jobs, [_this]()
+				{
+					run(_this);
+				});
+
+				return;
+			}
+
+			const std::vector<u32>& func = _this->funcs[_this->next];
+
+			// Initialize LS with function data only (compile() requires the analyser state)
+			for (u32 i = 1, pos = func[0]; i < func.size(); i++, pos += 4)
+			{
+				ls[pos / 4] = se_storage<u32>::swap(func[i]);
+			}
+
+			compiler.analyse(ls.data(), func[0]);
+
+			if (!compiler.compile(_this->reset_count, func))
+			{
+				return;
+			}
+
+			std::memset(ls.data(), 0, 0x40000);
+		}
+	}
+};
+
+void spu_recompiler_base::relocate(u64 last_reset_count, std::vector<std::vector<u32>>&& hot)
+{
+	if (hot.empty() || Emu.IsStopped())
 	{
-		busy_wait();
+		return;
 	}
 
-	// Reinitialize (TODO)
-	jit_runtime::finalize();
-	jit_runtime::initialize();
-	return ++m_reset_count;
-}
+	const auto task = std::make_shared<spu_relocation>();
+	task->funcs = std::move(hot);
+	task->reset_count = last_reset_count;
 
-void spu_runtime::handle_return(spu_thread* _spu)
-{
-	// Wait until the runtime becomes available
-	writer_lock lock(*this);
+	// Use the same compiler as SPU threads
+	if (g_cfg.core.spu_decoder == spu_decoder_type::llvm && !g_cfg.core.spu_tiered_compilation)
+	{
+		task->compiler = make_llvm_recompiler();
+	}
+	else
+	{
+		task->compiler = make_asmjit_recompiler();
+	}
 
-	// Reset stack mirror
-	std::memset(_spu->stack_mirror.data(), 0xff, sizeof(spu_thread::stack_mirror));
+	if (!task->compiler)
+	{
+		return;
+	}
 
-	// Reset the flag
-	_spu->state -= cpu_flag::jit_return;
+	fxm::get_always<compile_scheduler>()->push(compile_priority::spu_relocate, task->jobs, [task]()
+	{
+		spu_relocation::run(task);
+	});
 }
 
-spu_recompiler_base::spu_recompiler_base()
+spu_function_t spu_recompiler_base::promote(u64 last_reset_count, const std::vector<u32>& func)
 {
-	result.reserve(8192);
+	m_promote = true;
+	const auto result = compile(last_reset_count, func);
+	m_promote = false;
+	return result;
 }
 
-spu_recompiler_base::~spu_recompiler_base()
+struct spu_llvm_tier::worker
 {
-}
+	lf_queue<std::pair<u64, std::vector<u32>>> registered;
 
-void spu_recompiler_base::make_function(const std::vector<u32>& data)
-{
-	for (u64 reset_count = m_spurt->get_reset_count();;)
+	void operator()()
 	{
-		if (LIKELY(compile(reset_count, data)))
+		// Don't compete with SPU threads
+		thread_ctrl::set_native_priority(-1);
+
+		const auto compiler = spu_recompiler_base::make_llvm_recompiler();
+
+		if (!compiler)
 		{
-			break;
+			return;
+		}
+
+		compiler->init();
+
+		for (auto slice = registered.pop_all(); thread_ctrl::state() != thread_state::aborting && !Emu.IsStopped(); slice ? slice.pop_front() : slice = registered.pop_all())
+		{
+			if (!slice)
+			{
+				registered.wait(1000);
+				continue;
+			}
+
+			// Register SPU runtime user
+			spu_runtime::passive_lock _passive_lock(compiler->get_runtime());
+
+			// Failure is not critical, the first tier function remains in use
+			compiler->promote(slice->first, slice->second);
 		}
+	}
+};
+
+spu_llvm_tier::spu_llvm_tier()
+{
+	const u32 max_threads = static_cast<u32>(g_cfg.core.llvm_threads);
+	const u32 thread_count = max_threads > 0 ? std::min(max_threads, std::thread::hardware_concurrency()) : std::thread::hardware_concurrency();
 
-		reset_count = m_spurt->reset(reset_count);
+	// Leave some cores for SPU threads
+	for (u32 i = 0; i < std::max<u32>(thread_count / 2, 1); i++)
+	{
+		m_workers.emplace_back(std::make_unique<named_thread<worker>>("SPU LLVM Worker " + std::to_string(i)));
 	}
 }
 
+spu_llvm_tier::~spu_llvm_tier()
+{
+}
+
+void spu_llvm_tier::push(u64 last_reset_count, const std::vector<u32>& func)
+{
+	// Distribute evenly between workers
+	m_workers[m_next++ % m_workers.size()]->registered.push(last_reset_count, func);
+}
+
 void spu_recompiler_base::dispatch(spu_thread& spu, void*, u8* rip)
 {
 	// If code verification failed from a patched patchpoint, clear it with a dispatcher jump
@@ -3158,6 +3723,13 @@ void spu_recompiler_base::dump(std::string& out)
 #include "llvm/Transforms/Scalar.h"
 #include "llvm/Transforms/IPO.h"
 #include "llvm/Transforms/Vectorize.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/ExecutionEngine/RTDyldMemoryManager.h"
+#include "llvm/IR/MDBuilder.h"
+
+// External symbols referenced by compiled SPU objects (name -> address), shared between compiler instances
+static shared_mutex s_spu_link_mutex;
+static std::unordered_map<std::string, u64> s_spu_link_table;
 
 class spu_llvm_recompiler : public spu_recompiler_base, public cpu_translator
 {
@@ -3179,6 +3751,24 @@ class spu_llvm_recompiler : public spu_recompiler_base, public cpu_translator
 	// Module name
 	std::string m_hash;
 
+	// Persistent object cache location (empty if disabled)
+	std::string m_obj_path;
+
+	// Object file name (depends on the profile usage)
+	std::string m_obj_name;
+
+	// Execution profile
+	std::shared_ptr<spu_profile> m_profile;
+
+	// Counters of the current function from the previous runs (empty if not hot enough)
+	std::vector<u64> m_prof_data;
+
+	// Global variable (execution counters, set if profiling)
+	llvm::GlobalVariable* m_prof_counters{};
+
+	// Entry counter of the current function (JIT eviction)
+	u64* m_hits{};
+
 	// Current function (chunk)
 	llvm::Function* m_function;
 
@@ -4106,7 +4696,200 @@ public:
 			// Metadata for branch weights
 			m_md_likely = llvm::MDTuple::get(m_context, {md_name, md_high, md_low});
 			m_md_unlikely = llvm::MDTuple::get(m_context, {md_name, md_low, md_high});
+
+			if (!m_interp_magn)
+			{
+				m_profile = fxm::get_always<spu_profile>();
+			}
+
+#ifndef _WIN32
+			// Not available on Windows (absolute dispatcher address is embedded in the code)
+			if (g_cfg.core.spu_cache && !m_interp_magn)
+			{
+				// Settings which affect codegen
+				enum class spu_settings : u32
+				{
+					verification,
+					accurate_xfloat,
+					approx_xfloat,
+					accurate_getllar,
+					accurate_putlluc,
+
+					__bitset_enum_max
+				};
+
+				be_t<bs_t<spu_settings>> settings{};
+
+				if (g_cfg.core.spu_verification)
+					settings += spu_settings::verification;
+				if (g_cfg.core.spu_accurate_xfloat)
+					settings += spu_settings::accurate_xfloat;
+				if (g_cfg.core.spu_approx_xfloat)
+					settings += spu_settings::approx_xfloat;
+				if (g_cfg.core.spu_accurate_getllar)
+					settings += spu_settings::accurate_getllar;
+				if (g_cfg.core.spu_accurate_putlluc)
+					settings += spu_settings::accurate_putlluc;
+
+				// Write version, block size, settings, CPU
+				fmt::append(m_obj_path, "%sspu-%s-v1-obj-%s-%s/", m_spurt->get_cache_path(), fmt::to_lower(g_cfg.core.spu_block_size.to_string()), fmt::base57(settings), jit_compiler::cpu(g_cfg.core.llvm_cpu));
+
+				if (!fs::create_path(m_obj_path))
+				{
+					LOG_ERROR(SPU, "LLVM: Failed to create object cache directory: %s (%s)", m_obj_path, fs::g_tls_error);
+					m_obj_path.clear();
+				}
+			}
+#endif
+		}
+	}
+
+	// Remember external symbols of the module for loading its object later
+	void register_links(const llvm::Module& module)
+	{
+		std::lock_guard lock(s_spu_link_mutex);
+
+		auto add = [&](const llvm::GlobalValue& gv)
+		{
+			// Patchpoints are unique for each object and recreated on load
+			if (!gv.isDeclaration() || gv.getName().startswith(m_hash))
+			{
+				return;
+			}
+
+			if (const auto addr = m_engine->getPointerToGlobalIfAvailable(gv.getName()))
+			{
+				s_spu_link_table[gv.getName().str()] = reinterpret_cast<u64>(addr);
+			}
+		};
+
+		for (const auto& func : module.functions())
+		{
+			if (!func.isIntrinsic())
+			{
+				add(func);
+			}
+		}
+
+		for (const auto& var : module.globals())
+		{
+			add(var);
+		}
+	}
+
+	// Try to load compiled function from the persistent object cache (sets corrupt if the file itself is unusable)
+	spu_function_t load_object(const std::string& path, bool& corrupt)
+	{
+		corrupt = false;
+
+		fs::file cached(path);
+
+		if (!cached)
+		{
+			return nullptr;
+		}
+
+		auto buf = llvm::WritableMemoryBuffer::getNewUninitMemBuffer(cached.size());
+
+		if (cached.read(buf->getBufferStart(), buf->getBufferSize()) != buf->getBufferSize())
+		{
+			LOG_ERROR(SPU, "LLVM: Truncated object: %s", path);
+			corrupt = true;
+			return nullptr;
+		}
+
+		auto obj = llvm::object::ObjectFile::createObjectFile(buf->getMemBufferRef());
+
+		if (!obj)
+		{
+			llvm::consumeError(obj.takeError());
+			LOG_ERROR(SPU, "LLVM: Invalid object: %s", path);
+			corrupt = true;
+			return nullptr;
+		}
+
+		// Resolve external symbols (0 = create patchpoint)
+		std::vector<std::pair<std::string, u64>> links;
+		{
+			reader_lock lock(s_spu_link_mutex);
+
+			for (const auto& sym : (*obj)->symbols())
+			{
+				if (!(sym.getFlags() & llvm::object::SymbolRef::SF_Undefined))
+				{
+					continue;
+				}
+
+				auto name = sym.getName();
+
+				if (!name)
+				{
+					llvm::consumeError(name.takeError());
+					LOG_ERROR(SPU, "LLVM: Invalid object: %s", path);
+					corrupt = true;
+					return nullptr;
+				}
+
+				if (name->startswith(m_hash + "-pp-"))
+				{
+					links.emplace_back(name->str(), 0);
+					continue;
+				}
+
+				if (*name == m_hash + "-hits")
+				{
+					if (!m_hits)
+					{
+						return nullptr;
+					}
+
+					links.emplace_back(name->str(), reinterpret_cast<u64>(m_hits));
+					continue;
+				}
+
+				if (*name == m_hash + "-prof")
+				{
+					if (!m_profile)
+					{
+						return nullptr;
+					}
+
+					links.emplace_back(name->str(), reinterpret_cast<u64>(m_profile->get(m_hash, m_size / 4 + 1)));
+					continue;
+				}
+
+				const auto found = s_spu_link_table.find(name->str());
+
+				if (found != s_spu_link_table.end())
+				{
+					links.emplace_back(name->str(), found->second);
+					continue;
+				}
+
+				if (!llvm::RTDyldMemoryManager::getSymbolAddressInProcess(name->str()))
+				{
+					// Unknown helper, IR must be built at least once to bind it
+					return nullptr;
+				}
+			}
+		}
+
+		for (const auto& link : links)
+		{
+			const u64 addr = link.second ? link.second : reinterpret_cast<u64>(m_spurt->make_branch_patchpoint());
+
+			if (!addr)
+			{
+				return nullptr;
+			}
+
+			m_engine->updateGlobalMapping(link.first, addr);
 		}
+
+		m_engine->addObjectFile({std::move(*obj), std::move(buf)});
+		m_jit.fin();
+
+		return reinterpret_cast<spu_function_t>(m_jit.get(m_hash));
 	}
 
 	virtual spu_function_t compile(u64 last_reset_count, const std::vector<u32>& func) override
@@ -4116,7 +4899,7 @@ public:
 			return compile_interpreter();
 		}
 
-		const auto fn_location = m_spurt->find(last_reset_count, func);
+		const auto fn_location = m_spurt->find(last_reset_count, func, m_promote);
 
 		if (fn_location == spu_runtime::g_dispatcher)
 		{
@@ -4130,7 +4913,7 @@ public:
 
 		std::string log;
 
-		if (m_cache && g_cfg.core.spu_cache)
+		if (m_cache && g_cfg.core.spu_cache && !m_promote)
 		{
 			m_cache->add(func);
 		}
@@ -4147,6 +4930,76 @@ public:
 			fmt::append(m_hash, "spu-0x%05x-%s", func[0], fmt::base57(output));
 		}
 
+		m_pos = func[0];
+		m_base = func[0];
+		m_size = (func.size() - 1) * 4;
+		const u32 start = m_pos;
+		const u32 end = start + m_size;
+
+		// Use the profile if the function was hot enough
+		m_prof_data.clear();
+
+		if (m_profile)
+		{
+			m_prof_data = m_profile->snapshot(m_hash);
+
+			if (m_prof_data.size() != func.size() || m_prof_data.back() < 256)
+			{
+				m_prof_data.clear();
+			}
+		}
+
+		m_obj_name = m_hash;
+
+		if (!m_prof_data.empty())
+		{
+			m_obj_name += "-pgo";
+		}
+
+		if (g_cfg.core.spu_profiling)
+		{
+			m_obj_name += "-prof";
+		}
+
+		// Entry counter (must be known before loading the object, shared with the first tier)
+		m_hits = m_spurt->make_counter(fn_location);
+
+		if (m_hits)
+		{
+			m_obj_name += "-hits";
+		}
+
+		m_obj_name += ".obj";
+
+		// Check persistent object cache
+		bool obj_cached = !m_obj_path.empty() && !g_cfg.core.spu_debug && fs::is_file(m_obj_path + m_obj_name);
+
+		if (obj_cached)
+		{
+			bool corrupt = false;
+
+			if (const auto fn = load_object(m_obj_path + m_obj_name, corrupt))
+			{
+				LOG_NOTICE(SPU, "LLVM: Loaded %s", m_hash);
+
+				if (!m_spurt->add(last_reset_count, fn_location, fn))
+				{
+					return nullptr;
+				}
+
+				return fn;
+			}
+
+			if (corrupt)
+			{
+				// Remove bad object (otherwise the object cache would provide it again), compile from scratch
+				fs::remove_file(m_obj_path + m_obj_name);
+				obj_cached = false;
+			}
+
+			// Otherwise the object is valid but can't be linked yet (e.g. unbound helper): build IR, the object cache provides the code
+		}
+
 		if (m_cache)
 		{
 			LOG_SUCCESS(SPU, "LLVM: Building %s (size %u)...", m_hash, func.size() - 1);
@@ -4156,12 +5009,6 @@ public:
 			LOG_NOTICE(SPU, "Building function 0x%x... (size %u, %s)", func[0], func.size() - 1, m_hash);
 		}
 
-		m_pos = func[0];
-		m_base = func[0];
-		m_size = (func.size() - 1) * 4;
-		const u32 start = m_pos;
-		const u32 end = start + m_size;
-
 		if (g_cfg.core.spu_debug)
 		{
 			this->dump(log);
@@ -4171,7 +5018,7 @@ public:
 		using namespace llvm;
 
 		// Create LLVM module
-		std::unique_ptr<Module> module = std::make_unique<Module>(m_hash + ".obj", m_context);
+		std::unique_ptr<Module> module = std::make_unique<Module>(m_obj_name, m_context);
 		module->setTargetTriple(Triple::normalize(sys::getProcessTriple()));
 		module->setDataLayout(m_jit.get_engine().getTargetMachine()->createDataLayout());
 		m_module = module.get();
@@ -4183,6 +5030,16 @@ public:
 		// Helper for check_state. Used to not interfere with LICM pass.
 		m_fake_global1 = new llvm::GlobalVariable(*m_module, get_type<bool>(), false, llvm::GlobalValue::InternalLinkage, m_ir->getFalse());
 
+		// Execution counters (external, linked by name)
+		m_prof_counters = nullptr;
+
+		if (g_cfg.core.spu_profiling && m_profile)
+		{
+			const std::string prof_name = m_hash + "-prof";
+			m_prof_counters = new llvm::GlobalVariable(*m_module, llvm::ArrayType::get(get_type<u64>(), func.size()), false, llvm::GlobalValue::ExternalLinkage, nullptr, prof_name);
+			m_engine->addGlobalMapping(prof_name, reinterpret_cast<u64>(m_profile->get(m_hash, ::size32(func))));
+		}
+
 		// Add entry function (contains only state/code check)
 		const auto main_func = llvm::cast<llvm::Function>(m_module->getOrInsertFunction(m_hash, get_ftype<void, u8*, u8*, u64>()).getCallee());
 		const auto main_arg2 = &*(main_func->arg_begin() + 2);
@@ -4314,6 +5171,18 @@ public:
 		const auto pbcount = spu_ptr<u64>(&spu_thread::block_counter);
 		m_ir->CreateStore(m_ir->CreateAdd(m_ir->CreateLoad(pbcount), m_ir->getInt64(check_iterations)), pbcount);
 
+		// Count function entries (from the dispatcher or patched branches)
+		update_prof_counter(m_size / 4);
+
+		if (m_hits)
+		{
+			// Count function entries (JIT eviction)
+			const std::string hits_name = m_hash + "-hits";
+			const auto hits = new llvm::GlobalVariable(*m_module, get_type<u64>(), false, llvm::GlobalValue::ExternalLinkage, nullptr, hits_name);
+			m_engine->addGlobalMapping(hits_name, reinterpret_cast<u64>(m_hits));
+			m_ir->CreateStore(m_ir->CreateAdd(m_ir->CreateLoad(hits), m_ir->getInt64(1)), hits);
+		}
+
 		// Call the entry function chunk
 		const auto entry_chunk = add_function(m_pos);
 		const auto entry_call = m_ir->CreateCall(entry_chunk->chunk, {m_thread, m_lsptr, m_base_pc});
@@ -4516,6 +5385,9 @@ public:
 					}
 				}
 
+				// Count block entries
+				update_prof_counter((baddr - start) / 4);
+
 				// State check at the beginning of the chunk
 				if (need_check || (bi == 0 && g_cfg.core.spu_block_size != spu_block_size_type::safe))
 				{
@@ -4580,6 +5452,20 @@ public:
 
 				verify(HERE), m_block->block_end;
 			}
+
+			// Move blocks never executed in the profile to the end of the function
+			if (!m_prof_data.empty())
+			{
+				for (u32 baddr : m_block_queue)
+				{
+					const auto block = m_blocks[baddr].block;
+
+					if (baddr != m_entry && !m_prof_data[(baddr - start) / 4])
+					{
+						block->moveAfter(&block->getParent()->back());
+					}
+				}
+			}
 		}
 
 		// Create function table if necessary
@@ -4623,7 +5509,12 @@ public:
 		for (const auto& func : m_functions)
 		{
 			const auto f = func.second.fn ? func.second.fn : func.second.chunk;
-			pm.run(*f);
+
+			if (!obj_cached)
+			{
+				// Skip optimizations if the object will be taken from the cache
+				pm.run(*f);
+			}
 
 			for (auto& bb : *f)
 			{
@@ -4687,6 +5578,12 @@ public:
 			// Testing only
 			m_jit.add(std::move(module), m_spurt->get_cache_path() + "llvm/");
 		}
+		else if (!m_obj_path.empty())
+		{
+			// Save or load the object
+			register_links(*module);
+			m_jit.add(std::move(module), m_obj_path);
+		}
 		else
 		{
 			m_jit.add(std::move(module));
@@ -7738,6 +8635,37 @@ public:
 		return result;
 	}
 
+	// Increment execution counter (profiling)
+	void update_prof_counter(u32 index)
+	{
+		if (m_prof_counters)
+		{
+			const auto ptr = m_ir->CreateGEP(m_prof_counters, {m_ir->getInt64(0), m_ir->getInt64(index)});
+			m_ir->CreateStore(m_ir->CreateAdd(m_ir->CreateLoad(ptr), m_ir->getInt64(1)), ptr);
+		}
+	}
+
+	// Get branch weights from the profile (nullptr if unavailable)
+	llvm::MDNode* get_prof_weights(u32 taken, u32 next)
+	{
+		if (m_prof_data.empty() || taken - m_base >= m_size || next - m_base >= m_size)
+		{
+			return nullptr;
+		}
+
+		u64 wt = m_prof_data[(taken - m_base) / 4] + 1;
+		u64 wn = m_prof_data[(next - m_base) / 4] + 1;
+
+		// Scale down to 32-bit weights
+		while (std::max(wt, wn) > UINT32_MAX)
+		{
+			wt = wt / 2 + 1;
+			wn = wn / 2 + 1;
+		}
+
+		return llvm::MDBuilder(m_context).createBranchWeights(static_cast<u32>(wt), static_cast<u32>(wn));
+	}
+
 	llvm::BasicBlock* add_block_next()
 	{
 		if (m_interp_magn)
@@ -7925,7 +8853,7 @@ public:
 		{
 			m_block->block_end = m_ir->GetInsertBlock();
 			const auto cond = eval(extract(get_vr(op.rt), 3) == 0);
-			m_ir->CreateCondBr(cond.value, add_block(target), add_block(m_pos + 4));
+			m_ir->CreateCondBr(cond.value, add_block(target), add_block(m_pos + 4), get_prof_weights(target, m_pos + 4));
 		}
 	}
 
@@ -7946,7 +8874,7 @@ public:
 		{
 			m_block->block_end = m_ir->GetInsertBlock();
 			const auto cond = eval(extract(get_vr(op.rt), 3) != 0);
-			m_ir->CreateCondBr(cond.value, add_block(target), add_block(m_pos + 4));
+			m_ir->CreateCondBr(cond.value, add_block(target), add_block(m_pos + 4), get_prof_weights(target, m_pos + 4));
 		}
 	}
 
@@ -7967,7 +8895,7 @@ public:
 		{
 			m_block->block_end = m_ir->GetInsertBlock();
 			const auto cond = eval(extract(get_vr<u16[8]>(op.rt), 6) == 0);
-			m_ir->CreateCondBr(cond.value, add_block(target), add_block(m_pos + 4));
+			m_ir->CreateCondBr(cond.value, add_block(target), add_block(m_pos + 4), get_prof_weights(target, m_pos + 4));
 		}
 	}
 
@@ -7988,7 +8916,7 @@ public:
 		{
 			m_block->block_end = m_ir->GetInsertBlock();
 			const auto cond = eval(extract(get_vr<u16[8]>(op.rt), 6) != 0);
-			m_ir->CreateCondBr(cond.value, add_block(target), add_block(m_pos + 4));
+			m_ir->CreateCondBr(cond.value, add_block(target), add_block(m_pos + 4), get_prof_weights(target, m_pos + 4));
 		}
 	}
 
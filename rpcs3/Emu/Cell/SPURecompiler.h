@@ -10,6 +10,8 @@
 #include <memory>
 #include <string>
 #include <deque>
+#include <unordered_set>
+#include <unordered_map>
 
 // Helper class
 class spu_cache
@@ -33,6 +35,38 @@ public:
 	static void initialize();
 };
 
+// Helper class (execution profile of compiled SPU functions)
+class spu_profile
+{
+	mutable shared_mutex m_mutex;
+
+	// Counters for each function (name -> instruction slots followed by the entry counter)
+	std::unordered_map<std::string, std::vector<u64>> m_map;
+
+	// Functions whose counters were returned by get() (must not be reallocated)
+	std::unordered_set<std::string> m_used;
+
+	// Counters for size mismatches of used functions
+	std::deque<std::vector<u64>> m_unsaved;
+
+	// Profile file location
+	std::string m_path;
+
+public:
+	spu_profile();
+
+	~spu_profile();
+
+	// Get counters for the function (allocated if necessary, the pointer remains valid)
+	u64* get(const std::string& name, u32 size);
+
+	// Get a copy of the counters (empty if not found)
+	std::vector<u64> snapshot(const std::string& name) const;
+
+	// Write profile file
+	void save() const;
+};
+
 // Helper class
 class spu_runtime
 {
@@ -62,6 +96,48 @@ class spu_runtime
 	// Scratch vector
 	std::vector<std::pair<std::basic_string_view<u32>, spu_function_t>> m_flat_list;
 
+	// Functions compiled by the first tier, awaiting recompilation (opaque pointers)
+	std::unordered_set<const void*> m_tier0;
+
+	// Lookup table entry (immutable after publication)
+	struct lookup_entry
+	{
+		u32 addr;
+		spu_function_t func;
+		std::basic_string_view<u32> data;
+	};
+
+	// Lookup table keyed on (start address, first instruction), open addressing
+	struct lookup_table
+	{
+		u32 mask;
+		u32 count;
+		std::unique_ptr<atomic_t<const lookup_entry*>[]> slots;
+	};
+
+	// Current lookup table for lock-free readers (replaced atomically when full)
+	atomic_t<const lookup_table*> m_lookup{};
+
+	// All lookup tables and entries (old versions are freed on reset when no reader may exist)
+	std::vector<std::unique_ptr<lookup_table>> m_lookup_tables;
+	std::deque<lookup_entry> m_lookup_entries;
+
+	// Publish function in the lookup table (called with exclusive lock)
+	void lookup_add(u32 addr, std::basic_string_view<u32> data, spu_function_t func);
+
+	// Find function in the lookup table without locking
+	spu_function_t lookup_find(const u32* ls, u32 addr) const;
+
+	// Function entry counters for eviction (opaque pointer -> counter)
+	std::unordered_map<const void*, u64*> m_hits;
+	std::deque<u64> m_hit_counters;
+
+	// JIT memory usage after the last reset
+	u64 m_jit_base = 0;
+
+	// Set when the JIT memory budget is exceeded
+	atomic_t<bool> m_evict{false};
+
 public:
 
 	// Trampoline to spu_recompiler_base::dispatch
@@ -78,11 +154,11 @@ public:
 		return m_cache_path;
 	}
 
-	// Add compiled function and generate trampoline if necessary
-	bool add(u64 last_reset_count, void* where, spu_function_t compiled);
+	// Add compiled function and generate trampoline if necessary (tier0: mark for recompilation)
+	bool add(u64 last_reset_count, void* where, spu_function_t compiled, bool tier0 = false);
 
-	// Return opaque pointer for add()
-	void* find(u64 last_reset_count, const std::vector<u32>&);
+	// Return opaque pointer for add() (promote: only return the first tier function to replace)
+	void* find(u64 last_reset_count, const std::vector<u32>&, bool promote = false);
 
 	// Find existing function
 	spu_function_t find(const u32* ls, u32 addr) const;
@@ -99,6 +175,18 @@ public:
 	// Remove all compiled function and free JIT memory
 	u64 reset(std::size_t last_reset_count);
 
+	// Allocate entry counter for the opaque pointer returned by find() (nullptr if eviction is disabled)
+	u64* make_counter(void* where);
+
+	// Check whether the JIT memory budget is exceeded
+	bool evict_pending() const
+	{
+		return m_evict;
+	}
+
+	// Reset with the list of the most used functions to compile again
+	u64 evict(u64 last_reset_count, std::vector<std::vector<u32>>& hot);
+
 	// Handle cpu_flag::jit_return
 	void handle_return(spu_thread* _spu);
 
@@ -326,6 +414,9 @@ protected:
 
 	std::shared_ptr<spu_cache> m_cache;
 
+	// Set while replacing the first tier function
+	bool m_promote = false;
+
 private:
 	// For private use
 	std::bitset<0x10000> m_bits;
@@ -350,6 +441,12 @@ public:
 	// Compile function, handle failure
 	void make_function(const std::vector<u32>&);
 
+	// Recompile function compiled by the first tier (may fail)
+	spu_function_t promote(u64 last_reset_count, const std::vector<u32>&);
+
+	// Recompile functions kept after eviction in background
+	static void relocate(u64 last_reset_count, std::vector<std::vector<u32>>&& hot);
+
 	// Default dispatch function fallback (second arg is unused)
 	static void dispatch(spu_thread&, void*, u8* rip);
 
@@ -379,3 +476,21 @@ public:
 	// Create recompiler instance (LLVM)
 	static std::unique_ptr<spu_recompiler_base> make_llvm_recompiler(u8 magn = 0);
 };
+
+// Background LLVM compilers for tiered compilation (functions are run with ASMJIT meanwhile)
+class spu_llvm_tier
+{
+	struct worker;
+
+	std::vector<std::unique_ptr<named_thread<worker>>> m_workers;
+
+	atomic_t<u32> m_next{0};
+
+public:
+	spu_llvm_tier();
+
+	~spu_llvm_tier();
+
+	// Queue the first tier function for recompilation
+	void push(u64 last_reset_count, const std::vector<u32>& func);
+};
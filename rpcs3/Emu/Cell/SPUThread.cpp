@@ -67,6 +67,93 @@ static FORCE_INLINE void mov_rdata(decltype(spu_thread::rdata)& dst, const declt
 	}
 }
 
+// Copy 128 bytes with non-temporal stores (requires 16-byte aligned destination and _mm_sfence() after)
+static FORCE_INLINE void mov_rdata_nt(decltype(spu_thread::rdata)& dst, const decltype(spu_thread::rdata)& src)
+{
+	for (u32 i = 0; i < 8; i++)
+	{
+		_mm_stream_si128(&dst[i].vi, src[i].vi);
+	}
+}
+
+// Min size of PUT transfers which bypass the cache (max transfer size is 0x4000, including merged list elements)
+constexpr u32 s_dma_nt_min = 0x2000;
+
+// Copy DMA data (size must be a multiple of 16), nt: bypass the cache (for PUT only, LS data is likely to be accessed soon)
+static void mov_dma(u8* dst, const u8* src, u32 size, bool nt)
+{
+	if (nt)
+	{
+		while (size >= 128)
+		{
+			mov_rdata_nt(*reinterpret_cast<decltype(spu_thread::rdata)*>(dst), *reinterpret_cast<const decltype(spu_thread::rdata)*>(src));
+
+			dst += 128;
+			src += 128;
+			size -= 128;
+		}
+
+		_mm_sfence();
+	}
+
+	while (size >= 128)
+	{
+		mov_rdata(*reinterpret_cast<decltype(spu_thread::rdata)*>(dst), *reinterpret_cast<const decltype(spu_thread::rdata)*>(src));
+
+		dst += 128;
+		src += 128;
+		size -= 128;
+	}
+
+	while (size)
+	{
+		*reinterpret_cast<v128*>(dst) = *reinterpret_cast<const v128*>(src);
+
+		dst += 16;
+		src += 16;
+		size -= 16;
+	}
+}
+
+// Spin window bounds for blocking channel waits (TSC ticks)
+constexpr u32 s_spin_min = 1000;
+constexpr u32 s_spin_max = 200000;
+
+// Spin for the tuned window, returns true if the condition was met
+template <typename F>
+static bool spu_spin_wait(const spu_thread::channel_wait_t& info, u64 start, F&& test)
+{
+	while (!test())
+	{
+		if (__rdtsc() - start >= info.spin)
+		{
+			return false;
+		}
+
+		_mm_pause();
+	}
+
+	return true;
+}
+
+// Update spin window from measured wake latency
+static void spu_spin_update(spu_thread::channel_wait_t& info, u64 latency, bool parked)
+{
+	// Spin long enough to catch latencies seen so far; if wakeup takes too long spinning is a waste
+	const u64 target = latency * 2 <= s_spin_max ? std::max<u64>(latency * 2, s_spin_min) : s_spin_min;
+
+	info.spin = static_cast<u32>((info.spin * 3ull + target) / 4);
+
+	if (parked)
+	{
+		info.parks++;
+	}
+	else
+	{
+		info.spins++;
+	}
+}
+
 extern u64 get_timebased_time();
 extern u64 get_system_time();
 
@@ -985,6 +1072,15 @@ std::string spu_thread::dump() const
 	}
 
 	fmt::append(ret, "\nBlock Weight: %u (Retreats: %u)", block_counter, block_failure);
+	fmt::append(ret, "\nDMA: %u bytes (Locks: %u, Merged: %u)", dma_bytes, dma_locks, dma_merged);
+
+	for (u32 i = 0; i < ch_wait.size(); i++)
+	{
+		if (const auto& wait = ch_wait[i]; wait.spins || wait.parks)
+		{
+			fmt::append(ret, "\nWait [%s]: Spins: %u, Parks: %u (Window: %u)", spu_ch_name[i], wait.spins, wait.parks, wait.spin);
+		}
+	}
 	fmt::append(ret, "\n[%s]", ch_mfc_cmd);
 	fmt::append(ret, "\nTag Mask: 0x%08x", ch_tag_mask);
 	fmt::append(ret, "\nMFC Stall: 0x%08x", ch_stall_mask);
@@ -1146,8 +1242,17 @@ void spu_thread::cpu_task()
 			spu_runtime::g_gateway(*this, vm::_ptr<u8>(offset), nullptr);
 		}
 
+		u64 wait_spins = 0;
+		u64 wait_parks = 0;
+
+		for (const auto& wait : ch_wait)
+		{
+			wait_spins += wait.spins;
+			wait_parks += wait.parks;
+		}
+
 		// Print some stats
-		LOG_NOTICE(SPU, "Stats: Block Weight: %u (Retreats: %u);", block_counter, block_failure);
+		LOG_NOTICE(SPU, "Stats: Block Weight: %u (Retreats: %u); DMA: %u bytes (Locks: %u, Merged: %u); Channel waits: %u spins, %u parks;", block_counter, block_failure, dma_bytes, dma_locks, dma_merged, wait_spins, wait_parks);
 		cpu_stop();
 		return;
 	}
@@ -1231,7 +1336,8 @@ spu_thread::spu_thread(vm::addr_t ls, lv2_spu_group* group, u32 index, std::stri
 
 	if (g_cfg.core.spu_decoder == spu_decoder_type::llvm)
 	{
-		jit = spu_recompiler_base::make_llvm_recompiler();
+		// Tiered compilation: start with ASMJIT, recompile with LLVM in background
+		jit = g_cfg.core.spu_tiered_compilation ? spu_recompiler_base::make_asmjit_recompiler() : spu_recompiler_base::make_llvm_recompiler();
 	}
 
 	if (g_cfg.core.spu_decoder != spu_decoder_type::fast && g_cfg.core.spu_decoder != spu_decoder_type::precise)
@@ -1337,8 +1443,13 @@ void spu_thread::do_dma_transfer(const spu_mfc_cmd& args)
 	u8* dst = (u8*)vm::base(eal);
 	u8* src = (u8*)vm::base(offset + lsa);
 
+	dma_bytes += args.size;
+
 	if (UNLIKELY(!is_get && !g_use_rtm))
 	{
+		// One reservation lock per touched cache line
+		dma_locks += (eal + args.size - 1) / 128 - eal / 128 + 1;
+
 		switch (u32 size = args.size)
 		{
 		case 1:
@@ -1346,6 +1457,7 @@ void spu_thread::do_dma_transfer(const spu_mfc_cmd& args)
 			auto& res = vm::reservation_lock(eal, 1);
 			*reinterpret_cast<u8*>(dst) = *reinterpret_cast<const u8*>(src);
 			res.release(res.load() + 127);
+			vm::reservation_notifier(eal, 1).notify_all();
 			break;
 		}
 		case 2:
@@ -1353,6 +1465,7 @@ void spu_thread::do_dma_transfer(const spu_mfc_cmd& args)
 			auto& res = vm::reservation_lock(eal, 2);
 			*reinterpret_cast<u16*>(dst) = *reinterpret_cast<const u16*>(src);
 			res.release(res.load() + 127);
+			vm::reservation_notifier(eal, 2).notify_all();
 			break;
 		}
 		case 4:
@@ -1360,6 +1473,7 @@ void spu_thread::do_dma_transfer(const spu_mfc_cmd& args)
 			auto& res = vm::reservation_lock(eal, 4);
 			*reinterpret_cast<u32*>(dst) = *reinterpret_cast<const u32*>(src);
 			res.release(res.load() + 127);
+			vm::reservation_notifier(eal, 4).notify_all();
 			break;
 		}
 		case 8:
@@ -1367,49 +1481,39 @@ void spu_thread::do_dma_transfer(const spu_mfc_cmd& args)
 			auto& res = vm::reservation_lock(eal, 8);
 			*reinterpret_cast<u64*>(dst) = *reinterpret_cast<const u64*>(src);
 			res.release(res.load() + 127);
+			vm::reservation_notifier(eal, 8).notify_all();
 			break;
 		}
 		default:
 		{
-			if (((eal & 127) + size) <= 128)
+			// Lock and update each cache line separately
+			while (size)
 			{
-				// Lock one cache line
+				const u32 line_size = std::min<u32>(size, 128 - (eal & 127));
+
 				auto& res = vm::reservation_lock(eal, 128);
 
-				while (size)
+				if (line_size == 128)
 				{
-					*reinterpret_cast<v128*>(dst) = *reinterpret_cast<const v128*>(src);
-
-					dst += 16;
-					src += 16;
-					size -= 16;
+					mov_rdata(*reinterpret_cast<decltype(spu_thread::rdata)*>(dst), *reinterpret_cast<const decltype(spu_thread::rdata)*>(src));
+				}
+				else
+				{
+					for (u32 i = 0; i < line_size; i += 16)
+					{
+						*reinterpret_cast<v128*>(dst + i) = *reinterpret_cast<const v128*>(src + i);
+					}
 				}
 
 				res.release(res.load() + 127);
-				break;
-			}
+				vm::reservation_notifier(eal, 128).notify_all();
 
-			auto lock = vm::passive_lock(eal & -128u, ::align(eal + size, 128));
-
-			while (size >= 128)
-			{
-				mov_rdata(*reinterpret_cast<decltype(spu_thread::rdata)*>(dst), *reinterpret_cast<const decltype(spu_thread::rdata)*>(src));
-
-				dst += 128;
-				src += 128;
-				size -= 128;
+				eal += line_size;
+				dst += line_size;
+				src += line_size;
+				size -= line_size;
 			}
 
-			while (size)
-			{
-				*reinterpret_cast<v128*>(dst) = *reinterpret_cast<const v128*>(src);
-
-				dst += 16;
-				src += 16;
-				size -= 16;
-			}
-
-			lock->release(0);
 			break;
 		}
 		}
@@ -1446,24 +1550,7 @@ void spu_thread::do_dma_transfer(const spu_mfc_cmd& args)
 	}
 	default:
 	{
-		while (size >= 128)
-		{
-			mov_rdata(*reinterpret_cast<decltype(spu_thread::rdata)*>(dst), *reinterpret_cast<const decltype(spu_thread::rdata)*>(src));
-
-			dst += 128;
-			src += 128;
-			size -= 128;
-		}
-
-		while (size)
-		{
-			*reinterpret_cast<v128*>(dst) = *reinterpret_cast<const v128*>(src);
-
-			dst += 16;
-			src += 16;
-			size -= 16;
-		}
-
+		mov_dma(dst, src, size, !is_get && size >= s_dma_nt_min);
 		break;
 	}
 	}
@@ -1563,9 +1650,31 @@ bool spu_thread::do_list_transfer(spu_mfc_cmd& args)
 			transfer.cmd  = MFC(args.cmd & ~MFC_LIST_MASK);
 			transfer.size = size;
 
-			do_dma_transfer(transfer);
 			const u32 add_size = std::max<u32>(size, 16);
 			args.lsa += add_size;
+
+			// Merge following elements contiguous in both EA and LS into a single transfer (up to the max DMA size, spu_mfc_cmd::size is 16-bit)
+			while (args.size > 8 && !(item.sb & 0x8000) && transfer.size % 16 == 0 && addr % 16 == 0)
+			{
+				const list_element next = _ref<list_element>((args.eal + 8) & 0x3fff8);
+				const u32 next_size = next.ts & 0x7fff;
+
+				if (!next_size || next_size % 16 || transfer.size + next_size > 0x4000 || next.ea != addr + transfer.size || transfer.lsa + transfer.size + next_size > 0x40000 || u64{next.ea} + next_size > RAW_SPU_BASE_ADDR)
+				{
+					break;
+				}
+
+				LOG_TRACE(SPU, "LIST: addr=0x%x, size=0x%x, lsa=0x%05x, sb=0x%x (merged)", next.ea, next_size, args.lsa, next.sb);
+
+				transfer.size += next_size;
+				args.lsa += next_size;
+				args.eal += 8;
+				args.size -= 8;
+				item = next;
+				dma_merged++;
+			}
+
+			do_dma_transfer(transfer);
 		}
 
 		args.eal += 8;
@@ -1834,28 +1943,49 @@ bool spu_thread::process_mfc_cmd()
 				}
 			}
 		}
-		else
+		else if (g_cfg.core.spu_accurate_getllar)
 		{
 			auto& res = vm::reservation_lock(addr, 128);
 			const u64 old_time = res.load() & -128;
 
-			if (g_cfg.core.spu_accurate_getllar)
-			{
-				*reinterpret_cast<atomic_t<u32>*>(&data) += 0;
+			*reinterpret_cast<atomic_t<u32>*>(&data) += 0;
 
-				// Full lock (heavyweight)
-				// TODO: vm::check_addr
-				vm::writer_lock lock(addr);
+			// Full lock (heavyweight)
+			// TODO: vm::check_addr
+			vm::writer_lock lock(addr);
 
-				ntime = old_time;
-				mov_rdata(dst, data);
-				res.release(old_time);
-			}
-			else
+			ntime = old_time;
+			mov_rdata(dst, data);
+			res.release(old_time);
+		}
+		else
+		{
+			auto& res = vm::reservation_acquire(addr, 128);
+
+			// Read without locking, retry if the timestamp has changed (writers lock the reservation and advance it)
+			for (u64 i = 0;; i++)
 			{
-				ntime = old_time;
-				mov_rdata(dst, data);
-				res.release(old_time);
+				ntime = res.load();
+
+				if (LIKELY(!(ntime & 127)))
+				{
+					mov_rdata(dst, data);
+					std::atomic_thread_fence(std::memory_order_acquire);
+
+					if (LIKELY(res.load() == ntime))
+					{
+						break;
+					}
+				}
+
+				if (i < 20)
+				{
+					busy_wait(300);
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
 			}
 		}
 
@@ -1924,31 +2054,32 @@ bool spu_thread::process_mfc_cmd()
 			}
 			else if (auto& data = vm::_ref<decltype(rdata)>(addr); rtime == (vm::reservation_acquire(raddr, 128) & -128) && cmp_rdata(rdata, data))
 			{
-				auto& res = vm::reservation_lock(raddr, 128);
-				const u64 old_time = res.load() & -128;
+				auto& res = vm::reservation_acquire(raddr, 128);
 
-				if (rtime == old_time)
+				// Lock the reservation only if its timestamp is unchanged (never wait: concurrent writer would invalidate it anyway)
+				if (res.compare_and_swap_test(rtime, rtime + 1))
 				{
 					*reinterpret_cast<atomic_t<u32>*>(&data) += 0;
 
-					// Full lock (heavyweight)
-					// TODO: vm::check_addr
-					vm::writer_lock lock(addr);
+					if (!g_cfg.core.spu_lockless_putllc)
+					{
+						// Full lock (heavyweight)
+						// TODO: vm::check_addr
+						vm::writer_lock lock(addr);
 
-					if (cmp_rdata(rdata, data))
+						if (cmp_rdata(rdata, data))
+						{
+							mov_rdata(data, to_write);
+							result = 1;
+						}
+					}
+					else if (cmp_rdata(rdata, data))
 					{
 						mov_rdata(data, to_write);
-						res.release(old_time + 128);
 						result = 1;
 					}
-					else
-					{
-						res.release(old_time);
-					}
-				}
-				else
-				{
-					res.release(old_time);
+
+					res.release(result ? rtime + 128 : rtime);
 				}
 			}
 		}
@@ -2212,12 +2343,19 @@ s64 spu_thread::get_ch_value(u32 ch)
 			state += cpu_flag::wait;
 		}
 
-		for (int i = 0; i < 10 && channel.get_count() == 0; i++)
+		const cpu_stall_scope stall(this, cpu_stall::channel);
+
+		auto& wait = ch_wait[ch % ch_wait.size()];
+		const u64 start = __rdtsc();
+		const bool ready = channel.get_count() != 0;
+
+		if (!ready)
 		{
-			busy_wait();
+			spu_spin_wait(wait, start, [&] { return channel.get_count() != 0; });
 		}
 
 		u32 out = 0;
+		bool parked = false;
 
 		while (!channel.try_pop(out))
 		{
@@ -2226,9 +2364,15 @@ s64 spu_thread::get_ch_value(u32 ch)
 				return -1;
 			}
 
+			parked = true;
 			thread_ctrl::wait();
 		}
 
+		if (!ready)
+		{
+			spu_spin_update(wait, __rdtsc() - start, parked);
+		}
+
 		check_state();
 		return out;
 	};
@@ -2246,13 +2390,19 @@ s64 spu_thread::get_ch_value(u32 ch)
 			state += cpu_flag::wait;
 		}
 
-		while (true)
+		const cpu_stall_scope stall(this, cpu_stall::channel);
+
+		auto& wait = ch_wait[SPU_RdInMbox];
+		const u64 start = __rdtsc();
+		const bool ready = ch_in_mbox.get_count() != 0;
+
+		if (!ready)
 		{
-			for (int i = 0; i < 10 && ch_in_mbox.get_count() == 0; i++)
-			{
-				busy_wait();
-			}
+			spu_spin_wait(wait, start, [&] { return ch_in_mbox.get_count() != 0; });
+		}
 
+		for (bool parked = false;; parked = true)
+		{
 			u32 out = 0;
 
 			if (const uint old_count = ch_in_mbox.try_pop(out))
@@ -2262,6 +2412,11 @@ s64 spu_thread::get_ch_value(u32 ch)
 					int_ctrl[2].set(SPU_INT2_STAT_SPU_MAILBOX_THRESHOLD_INT);
 				}
 
+				if (!ready)
+				{
+					spu_spin_update(wait, __rdtsc() - start, parked);
+				}
+
 				check_state();
 				return out;
 			}
@@ -2357,6 +2512,17 @@ s64 spu_thread::get_ch_value(u32 ch)
 			return res;
 		}
 
+		const cpu_stall_scope stall(this, cpu_stall::channel);
+
+		auto& wait = ch_wait[SPU_RdEventStat];
+		const u64 start = __rdtsc();
+
+		if (spu_spin_wait(wait, start, [&] { return (res = get_events()) != 0; }))
+		{
+			spu_spin_update(wait, __rdtsc() - start, false);
+			return res;
+		}
+
 		const u32 mask1 = ch_event_mask;
 
 		if (mask1 & SPU_EVENT_LR && raddr)
@@ -2367,13 +2533,9 @@ s64 spu_thread::get_ch_value(u32 ch)
 				fmt::throw_exception("Not supported: event mask 0x%x" HERE, mask1);
 			}
 
+			// Notifier may be shared with other reservation lines, spurious wakeups are possible
 			const auto pseudo_lock = vm::reservation_notifier(raddr, 128).try_shared_lock();
 
-			if (!pseudo_lock)
-			{
-				fmt::throw_exception("Unexpected: reservation notifier lock failed");
-			}
-
 			while (res = get_events(), !res)
 			{
 				state += cpu_flag::wait;
@@ -2383,9 +2545,18 @@ s64 spu_thread::get_ch_value(u32 ch)
 					return -1;
 				}
 
-				pseudo_lock.wait(100);
+				if (LIKELY(pseudo_lock))
+				{
+					pseudo_lock.wait(100);
+				}
+				else
+				{
+					// All wait slots are occupied
+					thread_ctrl::wait_for(100);
+				}
 			}
 
+			spu_spin_update(wait, __rdtsc() - start, true);
 			check_state();
 			return res;
 		}
@@ -2402,6 +2573,7 @@ s64 spu_thread::get_ch_value(u32 ch)
 			thread_ctrl::wait_for(100);
 		}
 
+		spu_spin_update(wait, __rdtsc() - start, true);
 		check_state();
 		return res;
 	}
@@ -2433,6 +2605,8 @@ bool spu_thread::set_ch_value(u32 ch, u32 value)
 	{
 		if (offset >= RAW_SPU_BASE_ADDR)
 		{
+			const cpu_stall_scope stall(this, cpu_stall::channel);
+
 			while (!ch_out_intr_mbox.try_push(value))
 			{
 				state += cpu_flag::wait;
@@ -2584,6 +2758,8 @@ bool spu_thread::set_ch_value(u32 ch, u32 value)
 
 	case SPU_WrOutMbox:
 	{
+		const cpu_stall_scope stall(this, cpu_stall::channel);
+
 		while (!ch_out_mbox.try_push(value))
 		{
 			state += cpu_flag::wait;
@@ -578,6 +578,20 @@ public:
 	u64 block_recover = 0;
 	u64 block_failure = 0;
 
+	u64 dma_bytes = 0; // Bytes transferred by MFC commands
+	u64 dma_locks = 0; // Locks taken for DMA (without TSX)
+	u64 dma_merged = 0; // List elements merged into the previous transfer
+
+	// Adaptive spin-then-park state of a blocking channel
+	struct channel_wait_t
+	{
+		u32 spin = 10000; // Spin window (TSC ticks), tuned from measured wake latency
+		u64 spins = 0; // Waits completed while spinning
+		u64 parks = 0; // Waits which required parking the thread
+	};
+
+	std::array<channel_wait_t, 32> ch_wait{}; // Indexed by channel number
+
 	u64 saved_native_sp = 0; // Host thread's stack pointer for emulated longjmp
 
 	u8* memory_base_addr = vm::g_base_addr;
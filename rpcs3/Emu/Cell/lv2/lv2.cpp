@@ -1,5 +1,6 @@
 ﻿#include "stdafx.h"
 #include "Emu/System.h"
+#include "Utilities/asm.h"
 
 #include "Emu/Cell/PPUFunction.h"
 #include "Emu/Cell/ErrorCodes.h"
@@ -998,10 +999,148 @@ extern ppu_function_t ppu_get_syscall(u64 code)
 
 extern u64 get_system_time();
 
+// PPU scheduler queue: FIFO list for each priority and the bitmap of non-empty lists
+class lv2_ppu_queue
+{
+	static constexpr u32 prio_count = 4096;
+
+	std::array<std::vector<ppu_thread*>, prio_count> m_lists{};
+
+	// Non-empty lists
+	std::array<u64, prio_count / 64> m_bits{};
+
+	// Non-zero m_bits elements
+	u64 m_top = 0;
+
+	std::size_t m_size = 0;
+
+	static u32 index(u32 prio)
+	{
+		return std::min<u32>(prio, prio_count - 1);
+	}
+
+	bool remove_from(ppu_thread* ppu, u32 index)
+	{
+		auto& list = m_lists[index];
+
+		for (auto found = list.cbegin(), end = list.cend(); found != end; found++)
+		{
+			if (*found == ppu)
+			{
+				list.erase(found);
+				m_size--;
+
+				if (list.empty() && !(m_bits[index / 64] &= ~(1ull << (index % 64))))
+				{
+					m_top &= ~(1ull << (index / 64));
+				}
+
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+public:
+	std::size_t size() const
+	{
+		return m_size;
+	}
+
+	// Get FIFO list for the priority
+	const std::vector<ppu_thread*>& list(u32 prio) const
+	{
+		return m_lists[index(prio)];
+	}
+
+	// Add the thread after all threads of the same priority
+	void push(ppu_thread* ppu, u32 prio)
+	{
+		const u32 i = index(prio);
+		m_lists[i].emplace_back(ppu);
+		m_bits[i / 64] |= 1ull << (i % 64);
+		m_top |= 1ull << (i / 64);
+		m_size++;
+	}
+
+	// Remove the thread (prio is the priority it was added with)
+	bool remove(ppu_thread* ppu, u32 prio)
+	{
+		if (remove_from(ppu, index(prio)))
+		{
+			return true;
+		}
+
+		// Fallback: search all lists
+		for (u64 top = m_top; top; top &= top - 1)
+		{
+			const u32 w = static_cast<u32>(utils::cnttz64(top, true));
+
+			for (u64 bits = m_bits[w]; bits; bits &= bits - 1)
+			{
+				if (remove_from(ppu, w * 64 + static_cast<u32>(utils::cnttz64(bits, true))))
+				{
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+	bool contains(ppu_thread* ppu, u32 prio) const
+	{
+		const auto& list = m_lists[index(prio)];
+		return std::find(list.cbegin(), list.cend(), ppu) != list.cend();
+	}
+
+	// Call func for each thread in the scheduling order until it returns false
+	template <typename F>
+	void for_each(F&& func) const
+	{
+		for (u64 top = m_top; top; top &= top - 1)
+		{
+			const u32 w = static_cast<u32>(utils::cnttz64(top, true));
+
+			for (u64 bits = m_bits[w]; bits; bits &= bits - 1)
+			{
+				for (ppu_thread* ppu : m_lists[w * 64 + static_cast<u32>(utils::cnttz64(bits, true))])
+				{
+					if (!func(ppu))
+					{
+						return;
+					}
+				}
+			}
+		}
+	}
+
+	void clear()
+	{
+		for (u64 top = m_top; top; top &= top - 1)
+		{
+			const u32 w = static_cast<u32>(utils::cnttz64(top, true));
+
+			for (u64 bits = m_bits[w]; bits; bits &= bits - 1)
+			{
+				m_lists[w * 64 + static_cast<u32>(utils::cnttz64(bits, true))].clear();
+			}
+
+			m_bits[w] = 0;
+		}
+
+		m_top = 0;
+		m_size = 0;
+	}
+};
+
 DECLARE(lv2_obj::g_mutex);
 DECLARE(lv2_obj::g_ppu);
 DECLARE(lv2_obj::g_pending);
+DECLARE(lv2_obj::g_waiting_mutex);
 DECLARE(lv2_obj::g_waiting);
+DECLARE(lv2_obj::g_stats);
 
 void lv2_obj::sleep_timeout(cpu_thread& thread, u64 timeout)
 {
@@ -1031,27 +1170,39 @@ void lv2_obj::sleep_timeout(cpu_thread& thread, u64 timeout)
 		}
 
 		// Find and remove the thread
-		unqueue(g_ppu, ppu);
+		g_ppu.remove(ppu, ppu->prio);
 		unqueue(g_pending, ppu);
 
 		ppu->start_time = start_time;
+		g_stats.sleeps++;
 	}
 
 	if (timeout)
 	{
 		const u64 wait_until = start_time + timeout;
 
-		// Register timeout if necessary
-		for (auto it = g_waiting.begin(), end = g_waiting.end(); it != end; it++)
+		std::lock_guard wlock(g_waiting_mutex);
+
+		// Register timeout (replace the previous one)
+		auto& id = g_waiting[&thread];
+
+		if (id)
 		{
-			if (it->first > wait_until)
+			fxm::check_unlocked<lv2_timer_wheel>()->cancel(id);
+		}
+
+		id = fxm::check_unlocked<lv2_timer_wheel>()->add(wait_until, [&thread](u64 wheel_id) -> u64
+		{
+			std::lock_guard lock(g_waiting_mutex);
+
+			if (const auto found = g_waiting.find(&thread); found != g_waiting.end() && found->second == wheel_id)
 			{
-				g_waiting.emplace(it, wait_until, &thread);
-				return;
+				g_waiting.erase(found);
+				thread.notify();
 			}
-		}
 
-		g_waiting.emplace_back(wait_until, &thread);
+			return 0;
+		});
 	}
 
 	schedule_all();
@@ -1062,66 +1213,57 @@ void lv2_obj::awake(cpu_thread& cpu, u32 prio)
 	// Check thread type
 	if (cpu.id_type() != 1) return;
 
+	auto& ppu = static_cast<ppu_thread&>(cpu);
+
 	std::lock_guard lock(g_mutex);
 
 	if (prio < INT32_MAX)
 	{
-        // Priority set
-        if (static_cast<ppu_thread&>(cpu).prio.exchange(prio) == prio || !unqueue(g_ppu, &cpu))
-        {
-            return;
-        }
+		// Priority set
+		const u32 old_prio = ppu.prio.exchange(prio);
+
+		if (old_prio == prio || !g_ppu.remove(&ppu, old_prio))
+		{
+			return;
+		}
 	}
 	else if (prio == -4)
 	{
 		// Yield command
 		const u64 start_time = get_system_time();
+		const auto& list = g_ppu.list(ppu.prio);
 
-		for (std::size_t i = 0, pos = -1; i < g_ppu.size(); i++)
+		if (!list.empty() && list.back() == &ppu)
 		{
-			if (g_ppu[i] == &cpu)
-			{
-				pos = i;
-				prio = g_ppu[i]->prio;
-			}
-			else if (i == pos + 1 && prio != -4 && g_ppu[i]->prio != prio)
-			{
-				return;
-			}
+			// No threads of the same priority to yield to
+			return;
 		}
 
-		unqueue(g_ppu, &cpu);
+		g_ppu.remove(&ppu, ppu.prio);
 		unqueue(g_pending, &cpu);
 
-		static_cast<ppu_thread&>(cpu).start_time = start_time;
+		ppu.start_time = start_time;
+		g_stats.yields++;
 	}
 
 	// Emplace current thread
-	for (std::size_t i = 0; i <= g_ppu.size(); i++)
+	if (g_ppu.contains(&ppu, ppu.prio))
+	{
+		LOG_TRACE(PPU, "sleep() - suspended (p=%zu)", g_pending.size());
+	}
+	else
 	{
-		if (i < g_ppu.size() && g_ppu[i] == &cpu)
-		{
-			LOG_TRACE(PPU, "sleep() - suspended (p=%zu)", g_pending.size());
-			break;
-		}
-
 		// Use priority, also preserve FIFO order
-		if (i == g_ppu.size() || g_ppu[i]->prio > static_cast<ppu_thread&>(cpu).prio)
-		{
-			LOG_TRACE(PPU, "awake(): %s", cpu.id);
-			g_ppu.insert(g_ppu.cbegin() + i, &static_cast<ppu_thread&>(cpu));
+		LOG_TRACE(PPU, "awake(): %s", cpu.id);
+		g_ppu.push(&ppu, ppu.prio);
 
-			// Unregister timeout if necessary
-			for (auto it = g_waiting.cbegin(), end = g_waiting.cend(); it != end; it++)
-			{
-				if (it->second == &cpu)
-				{
-					g_waiting.erase(it);
-					break;
-				}
-			}
+		// Unregister timeout if necessary
+		std::lock_guard wlock(g_waiting_mutex);
 
-			break;
+		if (const auto found = g_waiting.find(&cpu); found != g_waiting.end())
+		{
+			fxm::check_unlocked<lv2_timer_wheel>()->cancel(found->second);
+			g_waiting.erase(found);
 		}
 	}
 
@@ -1132,15 +1274,21 @@ void lv2_obj::awake(cpu_thread& cpu, u32 prio)
 	}
 
 	// Suspend threads if necessary
-	for (std::size_t i = g_cfg.core.ppu_threads; i < g_ppu.size(); i++)
+	if (const std::size_t limit = g_cfg.core.ppu_threads; g_ppu.size() > limit)
 	{
-		const auto target = g_ppu[i];
+		std::size_t i = 0;
 
-		if (!target->state.test_and_set(cpu_flag::suspend))
+		g_ppu.for_each([&](ppu_thread* target)
 		{
-			LOG_TRACE(PPU, "suspend(): %s", target->id);
-			g_pending.emplace_back(target);
-		}
+			if (i++ >= limit && !target->state.test_and_set(cpu_flag::suspend))
+			{
+				LOG_TRACE(PPU, "suspend(): %s", target->id);
+				g_pending.emplace_back(target);
+				g_stats.suspends++;
+			}
+
+			return true;
+		});
 	}
 
 	schedule_all();
@@ -1148,9 +1296,29 @@ void lv2_obj::awake(cpu_thread& cpu, u32 prio)
 
 void lv2_obj::cleanup()
 {
-	g_ppu.clear();
-	g_pending.clear();
-	g_waiting.clear();
+	{
+		std::lock_guard lock(g_mutex);
+
+		if (g_stats.wakeups)
+		{
+			LOG_NOTICE(PPU, "Scheduler stats: wake-ups: %u, sleeps: %u, yields: %u, suspensions: %u", g_stats.wakeups, g_stats.sleeps, g_stats.yields, g_stats.suspends);
+		}
+
+		g_ppu.clear();
+		g_pending.clear();
+		g_stats = {};
+	}
+
+	{
+		std::lock_guard wlock(g_waiting_mutex);
+		g_waiting.clear();
+	}
+
+	// Stop timer wheel (also removes sys_timer events)
+	if (const auto wheel = fxm::check_unlocked<lv2_timer_wheel>())
+	{
+		wheel->clear();
+	}
 }
 
 void lv2_obj::schedule_all()
@@ -1158,38 +1326,30 @@ void lv2_obj::schedule_all()
 	if (g_pending.empty())
 	{
 		// Wake up threads
-		for (std::size_t i = 0, x = std::min<std::size_t>(g_cfg.core.ppu_threads, g_ppu.size()); i < x; i++)
+		const std::size_t limit = g_cfg.core.ppu_threads;
+		std::size_t i = 0;
+
+		g_ppu.for_each([&](ppu_thread* target)
 		{
-			const auto target = g_ppu[i];
+			if (i++ >= limit)
+			{
+				return false;
+			}
 
 			if (target->state & cpu_flag::suspend)
 			{
 				LOG_TRACE(PPU, "schedule(): %s", target->id);
 				target->state ^= (cpu_flag::signal + cpu_flag::suspend);
 				target->start_time = 0;
+				g_stats.wakeups++;
 
 				if (target != get_current_cpu_thread())
 				{
 					target->notify();
 				}
 			}
-		}
-	}
-
-	// Check registered timeouts
-	while (!g_waiting.empty())
-	{
-		auto& pair = g_waiting.front();
 
-		if (pair.first <= get_system_time())
-		{
-			pair.second->notify();
-			g_waiting.pop_front();
-		}
-		else
-		{
-			// The list is sorted so assume no more timeouts
-			break;
-		}
+			return true;
+		});
 	}
 }
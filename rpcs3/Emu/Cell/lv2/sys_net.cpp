@@ -24,6 +24,10 @@
 #include <poll.h>
 #endif
 
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+
 
 
 LOG_CHANNEL(sys_net);
@@ -32,8 +36,64 @@ static std::vector<ppu_thread*> s_to_awake;
 
 static shared_mutex s_nw_mutex;
 
+#ifdef __linux__
+// Sockets are registered once with EPOLLONESHOT and rearmed when events are selected (data is the socket id)
+static int s_epoll_fd = -1;
+#endif
+
 extern u64 get_system_time();
 
+// Register new socket for polling
+static void network_register(lv2_socket& sock, u32 id)
+{
+	sock.id = id;
+
+#ifdef __linux__
+	::epoll_event ev{};
+	ev.events = EPOLLONESHOT;
+	ev.data.u32 = id;
+
+	if (s_epoll_fd >= 0 && ::epoll_ctl(s_epoll_fd, EPOLL_CTL_ADD, sock.socket, &ev) != 0)
+	{
+		sys_net.error("epoll_ctl(ADD) failed (s=%d, errno=%d)", id, errno);
+	}
+#endif
+}
+
+#ifdef __linux__
+// Enable polling for selected events (must be called after modifying them with sock.mutex locked)
+static void network_poll_arm(lv2_socket& sock)
+{
+	const auto selected = sock.events.load();
+
+	if (!selected || s_epoll_fd < 0)
+	{
+		return;
+	}
+
+	::epoll_event ev{};
+	ev.events = EPOLLONESHOT |
+		(selected & lv2_socket::poll::read ? EPOLLIN : 0) |
+		(selected & lv2_socket::poll::write ? EPOLLOUT : 0);
+	ev.data.u32 = sock.id;
+
+	if (::epoll_ctl(s_epoll_fd, EPOLL_CTL_MOD, sock.socket, &ev) != 0)
+	{
+		sys_net.error("epoll_ctl(MOD) failed (s=%d, errno=%d)", sock.id, errno);
+	}
+}
+#endif
+
+// Select events for polling
+static void network_poll_add(lv2_socket& sock, bs_t<lv2_socket::poll> events)
+{
+	sock.events += events;
+
+#ifdef __linux__
+	network_poll_arm(sock);
+#endif
+}
+
 // Error helper functions
 static s32 get_last_error(bool is_blocking, int native_error = 0)
 {
@@ -110,6 +170,102 @@ static void network_clear_queue(ppu_thread& ppu)
 	});
 }
 
+#ifdef __linux__
+static void network_dispatch(lv2_socket& sock, bs_t<lv2_socket::poll> events);
+
+extern void network_thread_init()
+{
+	s_epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+
+	if (s_epoll_fd < 0)
+	{
+		sys_net.fatal("epoll_create1() failed (errno=%d)", errno);
+		return;
+	}
+
+	thread_ctrl::spawn("Network Thread", []()
+	{
+		s_to_awake.clear();
+
+		::epoll_event events[64];
+
+		while (!Emu.IsStopped())
+		{
+			// Wait for readiness (the timeout is only used for checking the emulation state)
+			const int count = ::epoll_wait(s_epoll_fd, events, 64, 100);
+
+			std::lock_guard lock(s_nw_mutex);
+
+			for (int i = 0; i < count; i++)
+			{
+				const auto sock = idm::get<lv2_socket>(events[i].data.u32);
+
+				if (!sock)
+				{
+					continue;
+				}
+
+				std::lock_guard sock_lock(sock->mutex);
+
+				const u32 revents = events[i].events;
+
+				// EPOLLERR and EPOLLHUP are always reported and stay set: wake up every selected event (the operation will fail),
+				// otherwise rearming would report them again immediately
+				const u32 hangup = revents & (EPOLLERR | EPOLLHUP);
+
+				bs_t<lv2_socket::poll> selected{};
+
+				if (revents & (EPOLLIN | hangup) && sock->events.test_and_reset(lv2_socket::poll::read))
+					selected += lv2_socket::poll::read;
+				if (revents & (EPOLLOUT | hangup) && sock->events.test_and_reset(lv2_socket::poll::write))
+					selected += lv2_socket::poll::write;
+				if (revents & EPOLLERR && sock->events.test_and_reset(lv2_socket::poll::error))
+					selected += lv2_socket::poll::error;
+
+				network_dispatch(*sock, selected);
+
+				// Rearm if there are still selected events
+				network_poll_arm(*sock);
+			}
+
+			s_to_awake.erase(std::unique(s_to_awake.begin(), s_to_awake.end()), s_to_awake.end());
+
+			for (ppu_thread* ppu : s_to_awake)
+			{
+				network_clear_queue(*ppu);
+				lv2_obj::awake(*ppu);
+			}
+
+			s_to_awake.clear();
+		}
+
+		::close(std::exchange(s_epoll_fd, -1));
+	});
+}
+
+// Process the workload of the socket (sock.mutex must be locked)
+static void network_dispatch(lv2_socket& sock, bs_t<lv2_socket::poll> events)
+{
+	if (events)
+	{
+		for (auto it = sock.queue.begin(); events && it != sock.queue.end();)
+		{
+			if (it->second(events))
+			{
+				it = sock.queue.erase(it);
+				continue;
+			}
+
+			it++;
+		}
+
+		if (sock.queue.empty())
+		{
+			sock.events.store({});
+		}
+	}
+}
+#else
 extern void network_thread_init()
 {
 	thread_ctrl::spawn("Network Thread", []()
@@ -243,6 +399,7 @@ extern void network_thread_init()
 #endif
 	});
 }
+#endif
 
 lv2_socket::lv2_socket(lv2_socket::socket_type s)
 	: socket(s)
@@ -299,7 +456,7 @@ s32 sys_net_bnet_accept(ppu_thread& ppu, s32 s, vm::ptr<sys_net_sockaddr> addr,
 		}
 
 		// Enable read event
-		sock.events += lv2_socket::poll::read;
+		network_poll_add(sock, lv2_socket::poll::read);
 		sock.queue.emplace_back(ppu.id, [&](bs_t<lv2_socket::poll> events) -> bool
 		{
 			if (events & lv2_socket::poll::read)
@@ -316,7 +473,7 @@ s32 sys_net_bnet_accept(ppu_thread& ppu, s32 s, vm::ptr<sys_net_sockaddr> addr,
 				}
 			}
 
-			sock.events += lv2_socket::poll::read;
+			network_poll_add(sock, lv2_socket::poll::read);
 			return false;
 		});
 
@@ -371,6 +528,8 @@ s32 sys_net_bnet_accept(ppu_thread& ppu, s32 s, vm::ptr<sys_net_sockaddr> addr,
 		return -SYS_NET_EMFILE;
 	}
 
+	network_register(*newsock, result);
+
 	if (addr)
 	{
 		verify(HERE), native_addr.ss_family == AF_INET;
@@ -479,7 +638,7 @@ s32 sys_net_bnet_connect(ppu_thread& ppu, s32 s, vm::ptr<sys_net_sockaddr> addr,
 
 			if (result == SYS_NET_EINPROGRESS)
 			{
-				sock.events += lv2_socket::poll::write;
+				network_poll_add(sock, lv2_socket::poll::write);
 				sock.queue.emplace_back(u32{0}, [&sock](bs_t<lv2_socket::poll> events) -> bool
 				{
 					if (events & lv2_socket::poll::write)
@@ -502,7 +661,7 @@ s32 sys_net_bnet_connect(ppu_thread& ppu, s32 s, vm::ptr<sys_net_sockaddr> addr,
 						return true;
 					}
 
-					sock.events += lv2_socket::poll::write;
+					network_poll_add(sock, lv2_socket::poll::write);
 					return false;
 				});
 			}
@@ -510,7 +669,7 @@ s32 sys_net_bnet_connect(ppu_thread& ppu, s32 s, vm::ptr<sys_net_sockaddr> addr,
 			return false;
 		}
 
-		sock.events += lv2_socket::poll::write;
+		network_poll_add(sock, lv2_socket::poll::write);
 		sock.queue.emplace_back(ppu.id, [&](bs_t<lv2_socket::poll> events) -> bool
 		{
 			if (events & lv2_socket::poll::write)
@@ -534,7 +693,7 @@ s32 sys_net_bnet_connect(ppu_thread& ppu, s32 s, vm::ptr<sys_net_sockaddr> addr,
 				return true;
 			}
 
-			sock.events += lv2_socket::poll::write;
+			network_poll_add(sock, lv2_socket::poll::write);
 			return false;
 		});
 
@@ -922,7 +1081,7 @@ s32 sys_net_bnet_recvfrom(ppu_thread& ppu, s32 s, vm::ptr<void> buf, u32 len, s3
 		}
 
 		// Enable read event
-		sock.events += lv2_socket::poll::read;
+		network_poll_add(sock, lv2_socket::poll::read);
 		sock.queue.emplace_back(ppu.id, [&](bs_t<lv2_socket::poll> events) -> bool
 		{
 			if (events & lv2_socket::poll::read)
@@ -939,7 +1098,7 @@ s32 sys_net_bnet_recvfrom(ppu_thread& ppu, s32 s, vm::ptr<void> buf, u32 len, s3
 				}
 			}
 
-			sock.events += lv2_socket::poll::read;
+			network_poll_add(sock, lv2_socket::poll::read);
 			return false;
 		});
 
@@ -1085,7 +1244,7 @@ s32 sys_net_bnet_sendto(ppu_thread& ppu, s32 s, vm::cptr<void> buf, u32 len, s32
 		}
 
 		// Enable write event
-		sock.events += lv2_socket::poll::write;
+		network_poll_add(sock, lv2_socket::poll::write);
 		sock.queue.emplace_back(ppu.id, [&](bs_t<lv2_socket::poll> events) -> bool
 		{
 			if (events & lv2_socket::poll::write)
@@ -1102,7 +1261,7 @@ s32 sys_net_bnet_sendto(ppu_thread& ppu, s32 s, vm::cptr<void> buf, u32 len, s32
 				}
 			}
 
-			sock.events += lv2_socket::poll::write;
+			network_poll_add(sock, lv2_socket::poll::write);
 			return false;
 		});
 
@@ -1414,13 +1573,16 @@ s32 sys_net_bnet_socket(ppu_thread& ppu, s32 family, s32 type, s32 protocol)
 		return -get_last_error(false);
 	}
 
-	const s32 s = idm::import_existing<lv2_socket>(std::make_shared<lv2_socket>(native_socket));
+	const auto sock = std::make_shared<lv2_socket>(native_socket);
+	const s32 s = idm::import_existing<lv2_socket>(sock);
 
 	if (s == id_manager::id_traits<lv2_socket>::invalid)
 	{
 		return -SYS_NET_EMFILE;
 	}
 
+	network_register(*sock, s);
+
 	return s;
 }
 
@@ -1544,7 +1706,7 @@ s32 sys_net_bnet_poll(ppu_thread& ppu, vm::ptr<sys_net_pollfd> fds, s32 nfds, s3
 				//if (fds[i].events & SYS_NET_POLLPRI) // Unimplemented
 				//	selected += lv2_socket::poll::error;
 
-				sock->events += selected;
+				network_poll_add(*sock, selected);
 				sock->queue.emplace_back(ppu.id, [sock, selected, fds, i, &signaled, &ppu](bs_t<lv2_socket::poll> events)
 				{
 					if (events & selected)
@@ -1561,7 +1723,7 @@ s32 sys_net_bnet_poll(ppu_thread& ppu, vm::ptr<sys_net_pollfd> fds, s32 nfds, s3
 						return true;
 					}
 
-					sock->events += selected;
+					network_poll_add(*sock, selected);
 					return false;
 				});
 			}
@@ -1739,7 +1901,7 @@ s32 sys_net_bnet_select(ppu_thread& ppu, s32 nfds, vm::ptr<sys_net_fd_set> readf
 			{
 				std::lock_guard lock(sock->mutex);
 
-				sock->events += selected;
+				network_poll_add(*sock, selected);
 				sock->queue.emplace_back(ppu.id, [sock, selected, i, &rread, &rwrite, &rexcept, &signaled, &ppu](bs_t<lv2_socket::poll> events)
 				{
 					if (events & selected)
@@ -1756,7 +1918,7 @@ s32 sys_net_bnet_select(ppu_thread& ppu, s32 nfds, vm::ptr<sys_net_fd_set> readf
 						return true;
 					}
 
-					sock->events += selected;
+					network_poll_add(*sock, selected);
 					return false;
 				});
 			}
@@ -334,6 +334,9 @@ struct lv2_socket final
 	// Native socket (must be non-blocking)
 	socket_type socket;
 
+	// Socket id (used by the network thread)
+	u32 id = 0;
+
 	// Events selected for polling
 	atomic_bs_t<poll> events{};
 
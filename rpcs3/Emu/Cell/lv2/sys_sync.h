@@ -11,6 +11,7 @@
 #include "Emu/IPC.h"
 
 #include <deque>
+#include <unordered_map>
 
 // attr_protocol (waiting scheduling policy)
 enum
@@ -217,14 +218,26 @@ private:
 	// Scheduler mutex
 	static shared_mutex g_mutex;
 
-	// Scheduler queue for active PPU threads
-	static std::deque<class ppu_thread*> g_ppu;
+	// Scheduler queue for active PPU threads (per-priority FIFO lists)
+	static class lv2_ppu_queue g_ppu;
 
 	// Waiting for the response from
 	static std::deque<class cpu_thread*> g_pending;
 
-	// Scheduler queue for timeouts (wait until -> thread)
-	static std::deque<std::pair<u64, class cpu_thread*>> g_waiting;
+	// Timeout map mutex (locked after g_mutex)
+	static shared_mutex g_waiting_mutex;
+
+	// Registered timeouts (thread -> lv2_timer_wheel id)
+	static std::unordered_map<class cpu_thread*, u64> g_waiting;
+
+	// Scheduler event counters (protected by g_mutex)
+	static struct sched_stats
+	{
+		u64 wakeups;
+		u64 sleeps;
+		u64 yields;
+		u64 suspends;
+	} g_stats;
 
 	static void schedule_all();
 };
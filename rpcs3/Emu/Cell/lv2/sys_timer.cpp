@@ -15,63 +15,307 @@ LOG_CHANNEL(sys_timer);
 
 extern u64 get_system_time();
 
-void lv2_timer_context::operator()()
+#ifdef __linux__
+constexpr u32 host_min_quantum = 100;
+#else
+// Host scheduler quantum for windows (worst case)
+constexpr u32 host_min_quantum = 500;
+#endif
+
+// Max driver thread sleep duration
+constexpr u32 max_wait = 10000;
+
+struct lv2_timer_wheel::driver
 {
-	while (!Emu.IsStopped())
+	lv2_timer_wheel* const wheel;
+
+	void operator()()
 	{
-		const u32 _state = state;
+		thread_ctrl::set_native_priority(1);
 
-		if (_state == SYS_TIMER_STATE_RUN)
-		{
-			const u64 _now = get_system_time();
-			const u64 next = expire;
+		std::vector<std::pair<u64, entry*>> fired;
 
-			if (_now >= next)
+		while (thread_ctrl::state() != thread_state::aborting && !Emu.IsStopped())
+		{
+			u64 wait_until;
 			{
-				std::lock_guard lock(mutex);
+				std::lock_guard lock(wheel->m_mutex);
+				wheel->advance(get_system_time(), fired);
+				wheel->m_wait_until = wait_until = fired.empty() ? wheel->next_expire() : 0;
+			}
 
-				if (const auto queue = port.lock())
+			if (!fired.empty())
+			{
+				// Entries can't be removed while running
+				for (auto& [id, e] : fired)
 				{
-					queue->send(source, data1, data2, next);
+					const u64 next = e->func(id);
+
+					std::lock_guard lock(wheel->m_mutex);
+
+					e->running = false;
+
+					if (next && !e->cancelled)
+					{
+						wheel->place(id, next);
+					}
+					else
+					{
+						wheel->m_timers.erase(id);
+					}
 				}
 
-				if (period)
+				fired.clear();
+				continue;
+			}
+
+			const u64 now = get_system_time();
+
+			if (wait_until > now + host_min_quantum)
+			{
+				// Wait on multiple of min quantum for large durations (limited to notice the emulation stop)
+				const u64 remaining = std::min<u64>(wait_until - now, max_wait);
+				thread_ctrl::wait_for(remaining - (remaining % host_min_quantum));
+			}
+			else if (wait_until > now)
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+};
+
+lv2_timer_wheel::~lv2_timer_wheel()
+{
+	clear();
+}
+
+void lv2_timer_wheel::place(u64 id, u64 expire)
+{
+	m_timers[id].expire = expire;
+
+	// Round up to the tick
+	u64 tick = (expire + (1ull << tick_shift) - 1) >> tick_shift;
+
+	if (tick <= m_tick)
+	{
+		tick = m_tick + 1;
+	}
+
+	u32 level = 0;
+
+	while (level + 1 < level_count && tick - m_tick >= 1ull << (level_bits * (level + 1)))
+	{
+		level++;
+	}
+
+	if (tick - m_tick >= 1ull << (level_bits * level_count))
+	{
+		// Too far, will be placed again after cascading
+		tick = m_tick + (1ull << (level_bits * level_count)) - 1;
+	}
+
+	m_slots[level * level_size + (tick >> (level_bits * level)) % level_size].emplace_back(id);
+}
+
+void lv2_timer_wheel::advance(u64 now, std::vector<std::pair<u64, entry*>>& fired)
+{
+	const u64 target = now >> tick_shift;
+
+	if (m_timers.empty())
+	{
+		m_tick = std::max(m_tick, target);
+		return;
+	}
+
+	while (m_tick < target)
+	{
+		const u64 tick = m_tick + 1;
+
+		// Move timers from the upper levels
+		for (u32 level = level_count - 1; level > 0; level--)
+		{
+			if (tick % (1ull << (level_bits * level)) == 0)
+			{
+				const auto ids = std::exchange(m_slots[level * level_size + (tick >> (level_bits * level)) % level_size], {});
+
+				for (u64 id : ids)
 				{
-					// Set next expiration time and check again (HACK)
-					expire += period;
-					continue;
+					if (const auto found = m_timers.find(id); found != m_timers.end() && !found->second.running)
+					{
+						place(id, found->second.expire);
+					}
 				}
+			}
+		}
 
-				// Stop after oneshot
-				state.compare_and_swap_test(SYS_TIMER_STATE_RUN, SYS_TIMER_STATE_STOP);
+		m_tick = tick;
+
+		auto& slot = m_slots[tick % level_size];
+
+		if (slot.empty())
+		{
+			continue;
+		}
+
+		const auto ids = std::exchange(slot, {});
+
+		for (u64 id : ids)
+		{
+			const auto found = m_timers.find(id);
+
+			if (found == m_timers.end() || found->second.running)
+			{
 				continue;
 			}
 
-			// TODO: use single global dedicated thread for busy waiting, no timer threads
-			thread_ctrl::wait_for(next - _now);
+			if ((found->second.expire + (1ull << tick_shift) - 1) >> tick_shift > tick)
+			{
+				// Clamped timer
+				place(id, found->second.expire);
+				continue;
+			}
+
+			found->second.running = true;
+			fired.emplace_back(id, &found->second);
 		}
-		else if (_state == SYS_TIMER_STATE_STOP)
+
+		if (!fired.empty())
 		{
-			thread_ctrl::wait_for(10000);
+			return;
 		}
-		else
+	}
+}
+
+u64 lv2_timer_wheel::next_expire() const
+{
+	if (m_timers.empty())
+	{
+		return UINT64_MAX;
+	}
+
+	// Find the next non-empty slot until the next cascade
+	u64 tick = m_tick + 1;
+
+	for (; tick % level_size; tick++)
+	{
+		if (!m_slots[tick % level_size].empty())
 		{
 			break;
 		}
 	}
+
+	return tick << tick_shift;
+}
+
+u64 lv2_timer_wheel::add(u64 expire, callback_t func)
+{
+	std::lock_guard lock(m_mutex);
+
+	if (m_timers.empty())
+	{
+		m_tick = std::max(m_tick, get_system_time() >> tick_shift);
+	}
+
+	const u64 id = m_next_id++;
+	m_timers.emplace(id, entry{0, std::move(func), false, false});
+	place(id, expire);
+
+	if (!m_thread)
+	{
+		m_thread = std::make_unique<named_thread<driver>>("lv2 Timer Wheel", driver{this});
+	}
+	else if (expire < m_wait_until)
+	{
+		thread_ctrl::notify(*m_thread);
+	}
+
+	return id;
+}
+
+bool lv2_timer_wheel::cancel(u64 id)
+{
+	std::lock_guard lock(m_mutex);
+
+	const auto found = m_timers.find(id);
+
+	if (found == m_timers.end() || found->second.cancelled)
+	{
+		return false;
+	}
+
+	if (found->second.running)
+	{
+		// Removed by the driver thread
+		found->second.cancelled = true;
+		return true;
+	}
+
+	m_timers.erase(found);
+	return true;
+}
+
+void lv2_timer_wheel::clear()
+{
+	std::unique_ptr<named_thread<driver>> thread;
+	{
+		std::lock_guard lock(m_mutex);
+		thread = std::move(m_thread);
+	}
+
+	// Join the driver thread
+	thread.reset();
+
+	std::lock_guard lock(m_mutex);
+
+	m_timers.clear();
+
+	for (auto& slot : m_slots)
+	{
+		slot.clear();
+	}
+
+	m_wait_until = UINT64_MAX;
 }
 
-void lv2_timer_context::on_abort()
+u64 lv2_timer_context::check(u64 id, u64 now)
 {
-	// Signal thread using invalid state
-	state = -1;
+	std::lock_guard lock(mutex);
+
+	if (state != SYS_TIMER_STATE_RUN || id != wheel_id)
+	{
+		return 0;
+	}
+
+	const u64 next = expire;
+
+	if (now < next)
+	{
+		return next;
+	}
+
+	if (const auto queue = port.lock())
+	{
+		queue->send(source, data1, data2, next);
+	}
+
+	if (period)
+	{
+		// Set next expiration time (it will be checked again immediately if it's already passed)
+		expire = next + period;
+		return next + period;
+	}
+
+	// Stop after oneshot
+	state.compare_and_swap_test(SYS_TIMER_STATE_RUN, SYS_TIMER_STATE_STOP);
+	return 0;
 }
 
 error_code sys_timer_create(vm::ptr<u32> timer_id)
 {
 	sys_timer.warning("sys_timer_create(timer_id=*0x%x)", timer_id);
 
-	if (const u32 id = idm::make<lv2_obj, lv2_timer>("Timer Thread"))
+	if (const u32 id = idm::make<lv2_obj, lv2_timer>())
 	{
 		*timer_id = id;
 		return CELL_OK;
@@ -93,6 +337,8 @@ error_code sys_timer_destroy(u32 timer_id)
 			return CELL_EISCONN;
 		}
 
+		timer.state = SYS_TIMER_STATE_STOP;
+		fxm::check_unlocked<lv2_timer_wheel>()->cancel(timer.wheel_id);
 		return {};
 	});
 
@@ -150,7 +396,7 @@ error_code _sys_timer_start(u32 timer_id, u64 base_time, u64 period)
 
 	const auto timer = idm::check<lv2_obj, lv2_timer>(timer_id, [&](lv2_timer& timer) -> CellError
 	{
-		std::unique_lock lock(timer.mutex);
+		std::lock_guard lock(timer.mutex);
 
 		if (timer.state != SYS_TIMER_STATE_STOP)
 		{
@@ -167,8 +413,18 @@ error_code _sys_timer_start(u32 timer_id, u64 base_time, u64 period)
 		timer.period = period;
 		timer.state  = SYS_TIMER_STATE_RUN;
 
-		lock.unlock();
-		thread_ctrl::notify(timer);
+		timer.wheel_id = fxm::check_unlocked<lv2_timer_wheel>()->add(timer.expire, [timer_id](u64 id) -> u64
+		{
+			u64 next = 0;
+
+			idm::check<lv2_obj, lv2_timer>(timer_id, [&](lv2_timer& timer)
+			{
+				next = timer.check(id, get_system_time());
+			});
+
+			return next;
+		});
+
 		return {};
 	});
 
@@ -194,6 +450,7 @@ error_code sys_timer_stop(u32 timer_id)
 		std::lock_guard lock(timer.mutex);
 
 		timer.state = SYS_TIMER_STATE_STOP;
+		fxm::check_unlocked<lv2_timer_wheel>()->cancel(timer.wheel_id);
 	});
 
 	if (!timer)
@@ -260,6 +517,7 @@ error_code sys_timer_disconnect_event_queue(u32 timer_id)
 
 		timer.state = SYS_TIMER_STATE_STOP;
 		timer.port.reset();
+		fxm::check_unlocked<lv2_timer_wheel>()->cancel(timer.wheel_id);
 		return {};
 	});
 
@@ -293,17 +551,9 @@ error_code sys_timer_usleep(ppu_thread& ppu, u64 sleep_time)
 
 	if (sleep_time)
 	{
-#ifdef __linux__
-		constexpr u32 host_min_quantum = 100;
-#else
-		// Host scheduler quantum for windows (worst case)
-		// NOTE: On ps3 this function has very high accuracy
-		constexpr u32 host_min_quantum = 500;
-#endif
-
 		u64 passed = 0;
-		u64 remaining;
 
+		// NOTE: On ps3 this function has very high accuracy, the timeout is signaled by the timer wheel
 		lv2_obj::sleep(ppu, sleep_time);
 
 		while (sleep_time >= passed)
@@ -313,18 +563,7 @@ error_code sys_timer_usleep(ppu_thread& ppu, u64 sleep_time)
 				return 0;
 			}
 
-			remaining = sleep_time - passed;
-
-			if (remaining > host_min_quantum)
-			{
-				// Wait on multiple of min quantum for large durations
-				thread_ctrl::wait_for(remaining - (remaining % host_min_quantum));
-			}
-			else
-			{
-				// Try yielding. May cause long wake latency but helps weaker CPUs a lot by alleviating resource pressure
-				std::this_thread::yield();
-			}
+			thread_ctrl::wait_for(sleep_time - passed);
 
 			passed = (get_system_time() - ppu.start_time);
 		}
@@ -2,6 +2,12 @@
 
 #include "Utilities/Thread.h"
 
+#include <array>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+
 // Timer State
 enum : u32
 {
@@ -17,12 +23,76 @@ struct sys_timer_information_t
 	be_t<u32> pad;
 };
 
+// Hierarchical timer wheel with the single driver thread (lv2 timeouts, sys_timer events, sleep wake-ups)
+// Created on boot as fxm object, accessed with fxm::check_unlocked (may be used under lv2_obj::g_mutex)
+class lv2_timer_wheel
+{
+public:
+	// Called on expiration with the timer id, returns the next expiration time (0 to remove)
+	using callback_t = std::function<u64(u64 id)>;
+
+private:
+	static constexpr u32 tick_shift = 6; // 64 us
+	static constexpr u32 level_bits = 8;
+	static constexpr u32 level_size = 1u << level_bits;
+	static constexpr u32 level_count = 4;
+
+	struct entry
+	{
+		u64 expire;
+		callback_t func;
+		bool running;
+		bool cancelled;
+	};
+
+	struct driver;
+
+	shared_mutex m_mutex;
+
+	// Registered timers (id -> entry)
+	std::unordered_map<u64, entry> m_timers;
+
+	// Timer ids for each slot of each level
+	std::array<std::vector<u64>, level_size * level_count> m_slots;
+
+	// Last processed tick
+	u64 m_tick = 0;
+
+	u64 m_next_id = 1;
+
+	// Planned wake-up time of the driver thread
+	u64 m_wait_until = UINT64_MAX;
+
+	std::unique_ptr<named_thread<driver>> m_thread;
+
+	void place(u64 id, u64 expire);
+
+	// Process ticks up to the current time, get expired timers
+	void advance(u64 now, std::vector<std::pair<u64, entry*>>& fired);
+
+	// Get the time of the next possible expiration
+	u64 next_expire() const;
+
+public:
+	lv2_timer_wheel() = default;
+
+	~lv2_timer_wheel();
+
+	// Register timer, returns its id
+	u64 add(u64 expire, callback_t func);
+
+	bool cancel(u64 id);
+
+	// Remove all timers and stop the driver thread
+	void clear();
+};
+
 struct lv2_timer_context : lv2_obj
 {
 	static const u32 id_base = 0x11000000;
 
-	void operator()();
-	void on_abort();
+	// Timer wheel callback: send the event, returns next expiration time
+	u64 check(u64 id, u64 now);
 
 	shared_mutex mutex;
 	atomic_t<u32> state{SYS_TIMER_STATE_STOP};
@@ -34,9 +104,11 @@ struct lv2_timer_context : lv2_obj
 
 	atomic_t<u64> expire{0}; // Next expiration time
 	atomic_t<u64> period{0}; // Period (oneshot if 0)
+
+	u64 wheel_id = 0; // Current timer wheel registration
 };
 
-using lv2_timer = named_thread<lv2_timer_context>;
+using lv2_timer = lv2_timer_context;
 
 class ppu_thread;
 
@@ -45,8 +45,10 @@ namespace vm
 	// Reservation stats (compressed x16)
 	u8* const g_reservations = memory_reserve_4GiB((std::uintptr_t)g_stat_addr);
 
-	// Reservation sync variables
-	u8* const g_reservations2 = g_reservations + 0x10000000;
+	// Reservation sync variables (fixed-size table)
+	static shared_cond s_reservation_notifiers[reservation_notifier_count]{};
+
+	u8* const g_reservations2 = reinterpret_cast<u8*>(s_reservation_notifiers);
 
 	// Memory locations
 	std::vector<std::shared_ptr<block_t>> g_locations;
@@ -110,6 +112,8 @@ namespace vm
 			passive_unlock(cpu);
 		}
 
+		const cpu_stall_scope stall(&cpu, cpu_stall::memory);
+
 		::reader_lock lock(g_mutex);
 		_register_lock(&cpu);
 	}
@@ -137,6 +141,8 @@ namespace vm
 		}
 
 		{
+			const cpu_stall_scope stall(get_current_cpu_thread(), cpu_stall::memory);
+
 			::reader_lock lock(g_mutex);
 			_ret = _register_range_lock((u64)end << 32 | addr);
 		}
@@ -615,11 +621,9 @@ namespace vm
 			if (addr == 0x10000)
 			{
 				utils::memory_commit(g_reservations, 0x1000);
-				utils::memory_commit(g_reservations2, 0x1000);
 			}
 
 			utils::memory_commit(g_reservations + addr / 16, size / 16);
-			utils::memory_commit(g_reservations2 + addr / 16, size / 16);
 		}
 		else
 		{
@@ -627,12 +631,10 @@ namespace vm
 			for (u32 i = 0; i < 6; i++)
 			{
 				utils::memory_commit(g_reservations + addr / 16 + i * 0x10000, 0x4000);
-				utils::memory_commit(g_reservations2 + addr / 16 + i * 0x10000, 0x4000);
 			}
 
 			// End of the address space
 			utils::memory_commit(g_reservations + 0xfff0000, 0x10000);
-			utils::memory_commit(g_reservations2 + 0xfff0000, 0x10000);
 		}
 
 		if (flags & 0x100)
@@ -101,10 +101,15 @@ namespace vm
 		reservation_acquire(addr, size) += 128;
 	}
 
-	// Get reservation sync variable
+	// Number of reservation sync variables (hashed by reservation line)
+	constexpr u32 reservation_notifier_count = 0x10000;
+
+	// Get reservation sync variable (may be shared with other reservation lines)
 	inline shared_cond& reservation_notifier(u32 addr, u32 size)
 	{
-		return *reinterpret_cast<shared_cond*>(g_reservations2 + addr / 128 * 8);
+		// Fibonacci hashing of line index (scatter adjacent lines across the table)
+		const u32 index = (addr / 128 * 0x9e3779b9u) >> 16;
+		return *reinterpret_cast<shared_cond*>(g_reservations2 + index * 8);
 	}
 
 	void reservation_lock_internal(atomic_t<u64>&);
@@ -17,6 +17,18 @@ const bool s_use_ssse3 =
 #define _mm_shuffle_epi8
 #endif
 
+// Wider kernels are compiled for their target and selected at runtime
+#ifdef _MSC_VER
+#define AVX2_FUNC
+#define AVX512_FUNC
+#else
+#define AVX2_FUNC __attribute__((__target__("avx2")))
+#define AVX512_FUNC __attribute__((__target__("avx512f,avx512bw,avx512vl")))
+#endif
+
+const bool s_use_avx2 = utils::has_avx2();
+const bool s_use_avx512 = utils::has_512();
+
 namespace
 {
 	// FIXME: GSL as_span break build if template parameter is non const with current revision.
@@ -53,6 +65,147 @@ namespace
 		return{ X, Y, Z, 1 };
 	}
 
+	// Byteswap shuffle mask for 16-bit or 32-bit elements of a 128-bit lane
+	template <typename T>
+	inline __m128i get_bswap_mask()
+	{
+		if constexpr (sizeof(T) == 2)
+		{
+			return _mm_set_epi8(0xE, 0xF, 0xC, 0xD, 0xA, 0xB, 0x8, 0x9, 0x6, 0x7, 0x4, 0x5, 0x2, 0x3, 0x0, 0x1);
+		}
+		else
+		{
+			return _mm_set_epi8(0xC, 0xD, 0xE, 0xF, 0x8, 0x9, 0xA, 0xB, 0x4, 0x5, 0x6, 0x7, 0x0, 0x1, 0x2, 0x3);
+		}
+	}
+
+	// Byteswap packed elements 64 bytes at a time, returns the number of elements processed
+	template <typename T>
+	AVX512_FUNC u32 stream_data_to_memory_swapped_avx512(void *dst, const void *src, u32 count)
+	{
+		const __m512i mask = _mm512_broadcast_i32x4(get_bswap_mask<T>());
+		const u32 iterations = count / (64 / sizeof(T));
+
+		for (u32 i = 0; i < iterations; ++i)
+		{
+			const __m512i vector = _mm512_loadu_si512(static_cast<const __m512i*>(src) + i);
+			_mm512_storeu_si512(static_cast<__m512i*>(dst) + i, _mm512_shuffle_epi8(vector, mask));
+		}
+
+		return iterations * (64 / sizeof(T));
+	}
+
+	// Byteswap packed elements 32 bytes at a time, returns the number of elements processed
+	template <typename T>
+	AVX2_FUNC u32 stream_data_to_memory_swapped_avx2(void *dst, const void *src, u32 count)
+	{
+		const __m256i mask = _mm256_broadcastsi128_si256(get_bswap_mask<T>());
+		const u32 iterations = count / (32 / sizeof(T));
+
+		for (u32 i = 0; i < iterations; ++i)
+		{
+			const __m256i vector = _mm256_loadu_si256(static_cast<const __m256i*>(src) + i);
+			_mm256_storeu_si256(static_cast<__m256i*>(dst) + i, _mm256_shuffle_epi8(vector, mask));
+		}
+
+		return iterations * (32 / sizeof(T));
+	}
+
+	// Process the bulk of a packed byteswap with the widest available vectors (multiple of 32 bytes)
+	template <typename T>
+	u32 stream_data_to_memory_swapped_wide(void *dst, const void *src, u32 count)
+	{
+		if (s_use_avx512)
+		{
+			return stream_data_to_memory_swapped_avx512<T>(dst, src, count);
+		}
+
+		if (s_use_avx2)
+		{
+			return stream_data_to_memory_swapped_avx2<T>(dst, src, count);
+		}
+
+		return 0;
+	}
+
+	// Strided byteswap of 16-byte blocks, two vertices per iteration (same access pattern as the SSE path)
+	// Returns the number of vertices processed, pointers are advanced past them
+	template <typename T>
+	AVX2_FUNC u32 stream_data_to_memory_swapped_non_continuous_avx2(char *&dst_ptr, const char *&src_ptr, u32 vertex_count, u8 dst_stride, u8 src_stride)
+	{
+		const __m256i mask = _mm256_broadcastsi128_si256(get_bswap_mask<T>());
+		const u32 iterations = vertex_count / 2;
+
+		for (u32 i = 0; i < iterations; ++i)
+		{
+			const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_ptr));
+			const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_ptr + src_stride));
+			const __m256i shuffled = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), mask);
+
+			// Stored in order, the second block overwrites any overlap like consecutive iterations would
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr), _mm256_castsi256_si128(shuffled));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr + dst_stride), _mm256_extracti128_si256(shuffled, 1));
+
+			src_ptr += 2 * src_stride;
+			dst_ptr += 2 * dst_stride;
+		}
+
+		return iterations * 2;
+	}
+
+	// Expand 8 CMP vectors per iteration with a strided gather (see decode_cmp_vector), returns the number of vertices processed
+	AVX2_FUNC u32 decode_cmp_vectors_avx2(void *dst, const void *src, u32 count, u32 src_stride, u32 dst_stride, bool swap_endianness)
+	{
+		if (src_stride > INT32_MAX / 8)
+		{
+			return 0;
+		}
+
+		const __m256i offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(src_stride));
+		const __m256i mask = _mm256_broadcastsi128_si256(get_bswap_mask<u32>());
+		const __m256i mask11 = _mm256_set1_epi32(0x7FF);
+		const __m256i w = _mm256_set1_epi32(1 << 16);
+
+		const u32 iterations = count / 8;
+		const char *src_ptr = static_cast<const char*>(src);
+		char *dst_ptr = static_cast<char*>(dst);
+
+		alignas(32) u64 decoded[8];
+
+		for (u32 i = 0; i < iterations; ++i)
+		{
+			__m256i vector = _mm256_i32gather_epi32(reinterpret_cast<const int*>(src_ptr), offsets, 1);
+
+			if (swap_endianness)
+			{
+				vector = _mm256_shuffle_epi8(vector, mask);
+			}
+
+			const __m256i x = _mm256_slli_epi32(_mm256_and_si256(vector, mask11), 5);
+			const __m256i y = _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(vector, 11), mask11), 5);
+			const __m256i z = _mm256_slli_epi32(_mm256_srli_epi32(vector, 22), 6);
+
+			// Each vertex is X | Y << 16 | Z << 32 | 1 << 48
+			const __m256i xy = _mm256_or_si256(x, _mm256_slli_epi32(y, 16));
+			const __m256i zw = _mm256_or_si256(z, w);
+			const __m256i v0145 = _mm256_unpacklo_epi32(xy, zw);
+			const __m256i v2367 = _mm256_unpackhi_epi32(xy, zw);
+
+			_mm256_store_si256(reinterpret_cast<__m256i*>(decoded), _mm256_permute2x128_si256(v0145, v2367, 0x20));
+			_mm256_store_si256(reinterpret_cast<__m256i*>(decoded + 4), _mm256_permute2x128_si256(v0145, v2367, 0x31));
+
+			for (u32 n = 0; n < 8; ++n)
+			{
+				std::memcpy(dst_ptr, decoded + n, sizeof(u64));
+				dst_ptr += dst_stride;
+			}
+
+			src_ptr += 8 * src_stride;
+		}
+
+		return iterations * 8;
+	}
+
 	inline void stream_data_to_memory_swapped_u32(void *dst, const void *src, u32 vertex_count, u8 stride)
 	{
 		const __m128i mask = _mm_set_epi8(
@@ -61,10 +214,15 @@ namespace
 			0x4, 0x5, 0x6, 0x7,
 			0x0, 0x1, 0x2, 0x3);
 
-		__m128i* dst_ptr = (__m128i*)dst;
-		__m128i* src_ptr = (__m128i*)src;
+		u32 dword_count = (vertex_count * (stride >> 2));
+
+		// Multiple of 32 bytes, alignment of the rest is preserved
+		const u32 wide_count = stream_data_to_memory_swapped_wide<u32>(dst, src, dword_count);
+		dword_count -= wide_count;
+
+		__m128i* dst_ptr = (__m128i*)((u32*)dst + wide_count);
+		__m128i* src_ptr = (__m128i*)((const u32*)src + wide_count);
 
-		const u32 dword_count = (vertex_count * (stride >> 2));
 		const u32 iterations = dword_count >> 2;
 		const u32 remaining = dword_count % 4;
 
@@ -112,10 +270,15 @@ namespace
 			0x6, 0x7, 0x4, 0x5,
 			0x2, 0x3, 0x0, 0x1);
 
-		__m128i* dst_ptr = (__m128i*)dst;
-		__m128i* src_ptr = (__m128i*)src;
+		u32 word_count = (vertex_count * (stride >> 1));
+
+		// Multiple of 32 bytes, alignment of the rest is preserved
+		const u32 wide_count = stream_data_to_memory_swapped_wide<u16>(dst, src, word_count);
+		word_count -= wide_count;
+
+		__m128i* dst_ptr = (__m128i*)((u16*)dst + wide_count);
+		__m128i* src_ptr = (__m128i*)((const u16*)src + wide_count);
 
-		const u32 word_count = (vertex_count * (stride >> 1));
 		const u32 iterations = word_count >> 3;
 		const u32 remaining = word_count % 8;
 
@@ -162,7 +325,7 @@ namespace
 			0x4, 0x5, 0x6, 0x7,
 			0x0, 0x1, 0x2, 0x3);
 
-		char *src_ptr = (char *)src;
+		const char *src_ptr = (const char *)src;
 		char *dst_ptr = (char *)dst;
 
 		//Count vertices to copy
@@ -181,6 +344,11 @@ namespace
 
 		if (LIKELY(s_use_ssse3))
 		{
+			if (s_use_avx2)
+			{
+				iterations -= stream_data_to_memory_swapped_non_continuous_avx2<u32>(dst_ptr, src_ptr, iterations, dst_stride, src_stride);
+			}
+
 			for (u32 i = 0; i < iterations; ++i)
 			{
 				const __m128i vector = _mm_loadu_si128((__m128i*)src_ptr);
@@ -227,7 +395,7 @@ namespace
 			0x6, 0x7, 0x4, 0x5,
 			0x2, 0x3, 0x0, 0x1);
 
-		char *src_ptr = (char *)src;
+		const char *src_ptr = (const char *)src;
 		char *dst_ptr = (char *)dst;
 
 		const bool is_128_aligned = !((dst_stride | src_stride) & 15);
@@ -245,6 +413,11 @@ namespace
 
 		if (LIKELY(s_use_ssse3))
 		{
+			if (s_use_avx2)
+			{
+				iterations -= stream_data_to_memory_swapped_non_continuous_avx2<u16>(dst_ptr, src_ptr, iterations, dst_stride, src_stride);
+			}
+
 			for (u32 i = 0; i < iterations; ++i)
 			{
 				const __m128i vector = _mm_loadu_si128((__m128i*)src_ptr);
@@ -520,7 +693,14 @@ void write_vertex_array_data_to_buffer(gsl::span<gsl::byte> raw_dst_span, gsl::s
 	case rsx::vertex_base_type::cmp:
 	{
 		gsl::span<u16> dst_span = as_span_workaround<u16>(raw_dst_span);
-		for (u32 i = 0; i < count; ++i)
+		u32 i = 0;
+
+		if (s_use_avx2)
+		{
+			i = decode_cmp_vectors_avx2(raw_dst_span.data(), src_ptr.data(), count, attribute_src_stride, dst_stride, swap_endianness);
+		}
+
+		for (; i < count; ++i)
 		{
 			u32 src_value;
 			memcpy(&src_value, src_ptr.subspan(attribute_src_stride * i).data(), sizeof(u32));
@@ -558,6 +738,231 @@ namespace
 		return value;
 	}
 
+	// Vectorized upload_untouched: byteswap with fused min/max and primitive restart handling
+	// Restart indices are replaced with index_limit<T>() (or skipped, in which case blocks containing them go through the scalar path)
+	template <typename T>
+	AVX2_FUNC std::tuple<T, T, u32> upload_untouched_avx2(const be_t<T> *src, T *dst, u32 count, bool restart, u32 restart_index, bool skip_restart)
+	{
+		constexpr u32 step = 32 / sizeof(T);
+
+		// Indices wider than T never match
+		restart = restart && restart_index <= index_limit<T>();
+
+		const __m256i mask = _mm256_broadcastsi128_si256(get_bswap_mask<T>());
+		const __m256i restart_vector = sizeof(T) == 2 ? _mm256_set1_epi16(static_cast<s16>(restart_index)) : _mm256_set1_epi32(restart_index);
+		__m256i min_vector = _mm256_set1_epi32(-1);
+		__m256i max_vector = _mm256_setzero_si256();
+
+		T min_index = index_limit<T>(), max_index = 0;
+		u32 src_index = 0;
+		u32 dst_index = 0;
+
+		for (; src_index + step <= count; src_index += step)
+		{
+			__m256i vector = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + src_index)), mask);
+			__m256i valid = vector;
+
+			if (restart)
+			{
+				const __m256i is_restart = sizeof(T) == 2 ? _mm256_cmpeq_epi16(vector, restart_vector) : _mm256_cmpeq_epi32(vector, restart_vector);
+
+				if (!_mm256_testz_si256(is_restart, is_restart))
+				{
+					if (skip_restart)
+					{
+						for (u32 i = src_index; i < src_index + step; ++i)
+						{
+							const T index = src[i];
+
+							if (index != restart_index)
+							{
+								dst[dst_index++] = min_max(min_index, max_index, index);
+							}
+						}
+
+						continue;
+					}
+
+					// All bits set is index_limit<T>(), which cannot lower the minimum; zero cannot raise the maximum
+					vector = _mm256_or_si256(vector, is_restart);
+					valid = _mm256_andnot_si256(is_restart, vector);
+				}
+			}
+
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + dst_index), vector);
+			dst_index += step;
+
+			if constexpr (sizeof(T) == 2)
+			{
+				min_vector = _mm256_min_epu16(min_vector, vector);
+				max_vector = _mm256_max_epu16(max_vector, valid);
+			}
+			else
+			{
+				min_vector = _mm256_min_epu32(min_vector, vector);
+				max_vector = _mm256_max_epu32(max_vector, valid);
+			}
+		}
+
+		alignas(32) T lanes[2][step];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lanes[0]), min_vector);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lanes[1]), max_vector);
+
+		for (u32 i = 0; i < step; ++i)
+		{
+			min_index = std::min(min_index, lanes[0][i]);
+			max_index = std::max(max_index, lanes[1][i]);
+		}
+
+		for (; src_index < count; ++src_index)
+		{
+			const T index = src[src_index];
+
+			if (restart && index == restart_index)
+			{
+				if (!skip_restart)
+				{
+					dst[dst_index++] = index_limit<T>();
+				}
+			}
+			else
+			{
+				dst[dst_index++] = min_max(min_index, max_index, index);
+			}
+		}
+
+		return std::make_tuple(min_index, max_index, dst_index);
+	}
+
+	// Same as upload_untouched_avx2 with 512-bit vectors and mask registers
+	template <typename T>
+	AVX512_FUNC std::tuple<T, T, u32> upload_untouched_avx512(const be_t<T> *src, T *dst, u32 count, bool restart, u32 restart_index, bool skip_restart)
+	{
+		constexpr u32 step = 64 / sizeof(T);
+
+		restart = restart && restart_index <= index_limit<T>();
+
+		const __m512i mask = _mm512_broadcast_i32x4(get_bswap_mask<T>());
+		const __m512i restart_vector = sizeof(T) == 2 ? _mm512_set1_epi16(static_cast<s16>(restart_index)) : _mm512_set1_epi32(restart_index);
+		const __m512i all_ones = _mm512_set1_epi32(-1);
+		__m512i min_vector = all_ones;
+		__m512i max_vector = _mm512_setzero_si512();
+
+		T min_index = index_limit<T>(), max_index = 0;
+		u32 src_index = 0;
+		u32 dst_index = 0;
+
+		for (; src_index + step <= count; src_index += step)
+		{
+			__m512i vector = _mm512_shuffle_epi8(_mm512_loadu_si512(src + src_index), mask);
+
+			if constexpr (sizeof(T) == 2)
+			{
+				const __mmask32 is_restart = restart ? _mm512_cmpeq_epi16_mask(vector, restart_vector) : 0;
+
+				if (is_restart && skip_restart)
+				{
+					for (u32 i = src_index; i < src_index + step; ++i)
+					{
+						const T index = src[i];
+
+						if (index != restart_index)
+						{
+							dst[dst_index++] = min_max(min_index, max_index, index);
+						}
+					}
+
+					continue;
+				}
+
+				vector = _mm512_mask_mov_epi16(vector, is_restart, all_ones);
+				min_vector = _mm512_min_epu16(min_vector, vector);
+				max_vector = _mm512_mask_max_epu16(max_vector, ~is_restart, max_vector, vector);
+			}
+			else
+			{
+				const __mmask16 is_restart = restart ? _mm512_cmpeq_epi32_mask(vector, restart_vector) : 0;
+
+				if (is_restart && skip_restart)
+				{
+					for (u32 i = src_index; i < src_index + step; ++i)
+					{
+						const T index = src[i];
+
+						if (index != restart_index)
+						{
+							dst[dst_index++] = min_max(min_index, max_index, index);
+						}
+					}
+
+					continue;
+				}
+
+				vector = _mm512_mask_mov_epi32(vector, is_restart, all_ones);
+				min_vector = _mm512_min_epu32(min_vector, vector);
+				max_vector = _mm512_mask_max_epu32(max_vector, ~is_restart, max_vector, vector);
+			}
+
+			_mm512_storeu_si512(dst + dst_index, vector);
+			dst_index += step;
+		}
+
+		alignas(64) T lanes[2][step];
+		_mm512_store_si512(lanes[0], min_vector);
+		_mm512_store_si512(lanes[1], max_vector);
+
+		for (u32 i = 0; i < step; ++i)
+		{
+			min_index = std::min(min_index, lanes[0][i]);
+			max_index = std::max(max_index, lanes[1][i]);
+		}
+
+		for (; src_index < count; ++src_index)
+		{
+			const T index = src[src_index];
+
+			if (restart && index == restart_index)
+			{
+				if (!skip_restart)
+				{
+					dst[dst_index++] = index_limit<T>();
+				}
+			}
+			else
+			{
+				dst[dst_index++] = min_max(min_index, max_index, index);
+			}
+		}
+
+		return std::make_tuple(min_index, max_index, dst_index);
+	}
+
+	// Write a repeating 48-index pattern, each repetition adds increment to the previous one
+	// Returns the number of indices written (a multiple of 48 not larger than count)
+	AVX2_FUNC u32 write_index_pattern_avx2(u16 *dst, u32 count, const u16 (&pattern)[48], const u16 (&increment)[48])
+	{
+		__m256i vector[3], step[3];
+
+		for (u32 i = 0; i < 3; ++i)
+		{
+			vector[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pattern) + i);
+			step[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(increment) + i);
+		}
+
+		u32 written = 0;
+
+		for (; written + 48 <= count; written += 48)
+		{
+			for (u32 i = 0; i < 3; ++i)
+			{
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + written) + i, vector[i]);
+				vector[i] = _mm256_add_epi16(vector[i], step[i]);
+			}
+		}
+
+		return written;
+	}
+
 	struct untouched_impl
 	{
 		template<typename T>
@@ -607,6 +1012,16 @@ namespace
 	template<typename T>
 	std::tuple<T, T, u32> upload_untouched(gsl::span<to_be_t<const T>> src, gsl::span<T> dst, rsx::primitive_type draw_mode, bool is_primitive_restart_enabled, u32 primitive_restart_index)
 	{
+		if (s_use_avx512)
+		{
+			return upload_untouched_avx512<T>(src.data(), dst.data(), ::size32(src), is_primitive_restart_enabled, primitive_restart_index, is_primitive_disjointed(draw_mode));
+		}
+
+		if (s_use_avx2)
+		{
+			return upload_untouched_avx2<T>(src.data(), dst.data(), ::size32(src), is_primitive_restart_enabled, primitive_restart_index, is_primitive_disjointed(draw_mode));
+		}
+
 		if (LIKELY(!is_primitive_restart_enabled))
 		{
 			return untouched_impl::upload_untouched(src, dst);
@@ -794,15 +1209,53 @@ void write_index_array_for_non_indexed_non_native_primitive_to_buffer(char* dst,
 		return;
 	case rsx::primitive_type::triangle_fan:
 	case rsx::primitive_type::polygon:
-		for (unsigned i = 0; i < (count - 2); i++)
+	{
+		unsigned i = 0;
+
+		if (s_use_avx2 && count > 2)
+		{
+			// 16 triangles per pattern, only the outer vertices advance
+			u16 pattern[48], increment[48];
+			for (u32 n = 0; n < 16; ++n)
+			{
+				pattern[3 * n] = 0;
+				pattern[3 * n + 1] = n + 1;
+				pattern[3 * n + 2] = n + 2;
+				increment[3 * n] = 0;
+				increment[3 * n + 1] = 16;
+				increment[3 * n + 2] = 16;
+			}
+
+			i = write_index_pattern_avx2(typedDst, (count - 2) * 3, pattern, increment) / 3;
+		}
+
+		for (; i < (count - 2); i++)
 		{
 			typedDst[3 * i] = 0;
 			typedDst[3 * i + 1] = i + 2 - 1;
 			typedDst[3 * i + 2] = i + 2;
 		}
 		return;
+	}
 	case rsx::primitive_type::quads:
-		for (unsigned i = 0; i < count / 4; i++)
+	{
+		unsigned i = 0;
+
+		if (s_use_avx2)
+		{
+			// 8 quads per pattern, each repetition advances by 32 vertices
+			const u16 quad[6] = { 0, 1, 2, 2, 3, 0 };
+			u16 pattern[48], increment[48];
+			for (u32 n = 0; n < 48; ++n)
+			{
+				pattern[n] = 4 * (n / 6) + quad[n % 6];
+				increment[n] = 32;
+			}
+
+			i = write_index_pattern_avx2(typedDst, count / 4 * 6, pattern, increment) / 6;
+		}
+
+		for (; i < count / 4; i++)
 		{
 			// First triangle
 			typedDst[6 * i] = 4 * i;
@@ -814,6 +1267,7 @@ void write_index_array_for_non_indexed_non_native_primitive_to_buffer(char* dst,
 			typedDst[6 * i + 5] = 4 * i;
 		}
 		return;
+	}
 	case rsx::primitive_type::quad_strip:
 	case rsx::primitive_type::points:
 	case rsx::primitive_type::lines:
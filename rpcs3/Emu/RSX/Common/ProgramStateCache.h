@@ -9,6 +9,9 @@
 #include "Utilities/mutex.h"
 
 #include <deque>
+#include <list>
+#include <thread>
+#include <unordered_set>
 
 enum class SHADER_TYPE
 {
@@ -145,6 +148,8 @@ public:
 		const vertex_program_type& vp;
 		const fragment_program_type& fp;
 		pipeline_properties props;
+		u64 priority = 0; // Request order, most recently requested tasks are processed first
+		bool in_progress = false;
 
 		async_link_task_entry(const vertex_program_type& _V, const fragment_program_type& _F, pipeline_properties _P)
 			: vp(_V), fp(_F), props(std::move(_P))
@@ -156,6 +161,8 @@ public:
 		RSXVertexProgram vp;
 		RSXFragmentProgram fp;
 		bool is_fp;
+		u64 priority = 0; // Request order, most recently requested tasks are processed first
+		bool in_progress = false;
 
 		std::vector<u8> tmp_cache;
 
@@ -176,6 +183,7 @@ public:
 protected:
 	shared_mutex m_pipeline_mutex;
 	shared_mutex m_decompiler_mutex;
+	shared_mutex m_program_mutex;
 
 	size_t m_next_id = 0;
 	bool m_cache_miss_flag; // Set if last lookup did not find any usable cached programs
@@ -185,57 +193,164 @@ protected:
 	binary_to_fragment_program m_fragment_shader_cache;
 	std::unordered_map <pipeline_key, pipeline_storage_type, pipeline_key_hash, pipeline_key_compare> m_storage;
 
+	// Programs which are still being compiled (inserted in the cache before compilation)
+	std::unordered_set<const void*> m_programs_in_progress;
+
 	std::unordered_map <pipeline_key, std::unique_ptr<async_link_task_entry>, pipeline_key_hash, pipeline_key_compare> m_link_queue;
-	std::deque<async_decompile_task_entry> m_decompile_queue;
+	std::list<async_decompile_task_entry> m_decompile_queue; // Entries must not move while in progress
+	atomic_t<u64> m_request_count{0};
 
 	vertex_program_type __null_vertex_program;
 	fragment_program_type __null_fragment_program;
 	pipeline_storage_type __null_pipeline_handle;
 
+	// Check whether the program is fully compiled (m_program_mutex must be locked)
+	bool is_program_ready(const void* program) const
+	{
+		return m_programs_in_progress.empty() || !m_programs_in_progress.count(program);
+	}
+
+	// Wait until another thread finishes compiling the program, returns false if waiting is not allowed
+	bool wait_for_program(const void* program, bool wait)
+	{
+		while (true)
+		{
+			{
+				reader_lock lock(m_program_mutex);
+
+				if (is_program_ready(program))
+				{
+					return true;
+				}
+			}
+
+			if (!wait)
+			{
+				return false;
+			}
+
+			std::this_thread::yield();
+		}
+	}
+
 	/// bool here to inform that the program was preexisting.
+	/// Thread-safe: programs are compiled outside of the lock, concurrent lookups of the same program wait for it
 	std::tuple<const vertex_program_type&, bool> search_vertex_program(const RSXVertexProgram& rsx_vp, bool force_load = true)
 	{
-		const auto& I = m_vertex_shader_cache.find(rsx_vp);
-		if (I != m_vertex_shader_cache.end())
+		vertex_program_type* found = nullptr;
+		vertex_program_type* new_shader = nullptr;
+		size_t id;
+
 		{
-			return std::forward_as_tuple(I->second, true);
+			reader_lock lock(m_program_mutex);
+
+			if (const auto I = m_vertex_shader_cache.find(rsx_vp); I != m_vertex_shader_cache.end())
+			{
+				found = &I->second;
+			}
+			else if (force_load)
+			{
+				lock.upgrade();
+
+				// Observed state could have been changed
+				const auto [It, inserted] = m_vertex_shader_cache.try_emplace(rsx_vp);
+
+				if (inserted)
+				{
+					new_shader = &It->second;
+					id = m_next_id++;
+					m_programs_in_progress.emplace(new_shader);
+				}
+				else
+				{
+					found = &It->second;
+				}
+			}
 		}
 
-		if (!force_load)
+		if (found)
+		{
+			if (wait_for_program(found, force_load))
+			{
+				return std::forward_as_tuple(*found, true);
+			}
+
+			return std::forward_as_tuple(__null_vertex_program, false);
+		}
+
+		if (!new_shader)
 		{
 			return std::forward_as_tuple(__null_vertex_program, false);
 		}
 
 		LOG_NOTICE(RSX, "VP not found in buffer!");
-		vertex_program_type& new_shader = m_vertex_shader_cache[rsx_vp];
-		backend_traits::recompile_vertex_program(rsx_vp, new_shader, m_next_id++);
+		backend_traits::recompile_vertex_program(rsx_vp, *new_shader, id);
+
+		std::lock_guard lock(m_program_mutex);
+		m_programs_in_progress.erase(new_shader);
 
-		return std::forward_as_tuple(new_shader, false);
+		return std::forward_as_tuple(*new_shader, false);
 	}
 
 	/// bool here to inform that the program was preexisting.
+	/// Thread-safe: programs are compiled outside of the lock, concurrent lookups of the same program wait for it
 	std::tuple<const fragment_program_type&, bool> search_fragment_program(const RSXFragmentProgram& rsx_fp, bool force_load = true)
 	{
-		const auto& I = m_fragment_shader_cache.find(rsx_fp);
-		if (I != m_fragment_shader_cache.end())
+		fragment_program_type* found = nullptr;
+		fragment_program_type* new_shader = nullptr;
+		size_t id;
+
+		{
+			reader_lock lock(m_program_mutex);
+
+			if (const auto I = m_fragment_shader_cache.find(rsx_fp); I != m_fragment_shader_cache.end())
+			{
+				found = &I->second;
+			}
+			else if (force_load)
+			{
+				lock.upgrade();
+
+				if (const auto I = m_fragment_shader_cache.find(rsx_fp); I != m_fragment_shader_cache.end())
+				{
+					// Observed state could have been changed
+					found = &I->second;
+				}
+				else
+				{
+					void* fragment_program_ucode_copy = malloc(rsx_fp.ucode_length);
+					std::memcpy(fragment_program_ucode_copy, rsx_fp.addr, rsx_fp.ucode_length);
+					RSXFragmentProgram new_fp_key = rsx_fp;
+					new_fp_key.addr = fragment_program_ucode_copy;
+					new_shader = &m_fragment_shader_cache[new_fp_key];
+					id = m_next_id++;
+					m_programs_in_progress.emplace(new_shader);
+				}
+			}
+		}
+
+		if (found)
 		{
-			return std::forward_as_tuple(I->second, true);
+			if (wait_for_program(found, force_load))
+			{
+				return std::forward_as_tuple(*found, true);
+			}
+
+			return std::forward_as_tuple(__null_fragment_program, false);
 		}
 
-		if (!force_load)
+		if (!new_shader)
 		{
 			return std::forward_as_tuple(__null_fragment_program, false);
 		}
 
 		LOG_NOTICE(RSX, "FP not found in buffer!");
-		void* fragment_program_ucode_copy = malloc(rsx_fp.ucode_length);
-		std::memcpy(fragment_program_ucode_copy, rsx_fp.addr, rsx_fp.ucode_length);
-		RSXFragmentProgram new_fp_key = rsx_fp;
-		new_fp_key.addr = fragment_program_ucode_copy;
-		fragment_program_type &new_shader = m_fragment_shader_cache[new_fp_key];
-		backend_traits::recompile_fragment_program(rsx_fp, new_shader, m_next_id++);
-
-		return std::forward_as_tuple(new_shader, false);
+		backend_traits::recompile_fragment_program(rsx_fp, *new_shader, id);
+
+		std::lock_guard lock(m_program_mutex);
+		m_programs_in_progress.erase(new_shader);
+
+		return std::forward_as_tuple(*new_shader, false);
 	}
 
 public:
@@ -334,58 +449,106 @@ public:
 		fmt::throw_exception("Trying to get unknown shader program" HERE);
 	}
 
-	// Returns 2 booleans.
-	// First flag hints that there is more work to do (busy hint)
-	// Second flag is true if at least one program has been linked successfully (sync hint)
+	// Returns the number of pending (including in-flight) decompile and link tasks
+	std::pair<u32, u32> get_async_queue_depth()
+	{
+		std::pair<u32, u32> result;
+
+		{
+			reader_lock lock(m_decompiler_mutex);
+			result.first = ::size32(m_decompile_queue);
+		}
+
+		{
+			reader_lock lock(m_pipeline_mutex);
+			result.second = ::size32(m_link_queue);
+		}
+
+		return result;
+	}
+
+	struct async_update_result
+	{
+		bool busy; // There is more work to do (busy hint)
+		bool decompiled; // At least one shader has been decompiled (sync hint if other workers may use it)
+		bool linked; // At least one program has been linked successfully (sync hint)
+	};
+
+	// Can be called by several workers, each task is taken by one worker with the most recently requested first
 	template<typename... Args>
-	std::pair<bool, bool> async_update(u32 max_decompile_count, Args&& ...args)
+	async_update_result async_update(u32 max_decompile_count, Args&& ...args)
 	{
 		// Decompile shaders and link one pipeline object per 'run'
 		// NOTE: Linking is much slower than decompilation step, so always decompile at least 1 unit
-		// TODO: Use try_lock instead
 		bool busy = false;
-		{
-			u32 count = 0;
-			std::lock_guard lock(m_decompiler_mutex);
+		bool decompiled = false;
 
-			while (!m_decompile_queue.empty())
+		for (u32 count = 0;; count++)
+		{
+			async_decompile_task_entry* decompile_task = nullptr;
 			{
-				const auto& decompile_task = m_decompile_queue.front();
-				if (decompile_task.is_fp)
+				std::lock_guard lock(m_decompiler_mutex);
+
+				for (auto& task : m_decompile_queue)
 				{
-					search_fragment_program(decompile_task.fp);
+					if (!task.in_progress && (!decompile_task || task.priority > decompile_task->priority))
+					{
+						decompile_task = &task;
+					}
 				}
-				else
+
+				if (!decompile_task)
 				{
-					search_vertex_program(decompile_task.vp);
+					break;
 				}
 
-				m_decompile_queue.pop_front();
-
-				if (++count >= max_decompile_count)
+				if (count >= max_decompile_count)
 				{
 					// Allows configurable decompiler 'load'
 					// Smaller unit count will release locks faster
 					busy = true;
 					break;
 				}
+
+				// Task stays queued until done so that it is not requested again meanwhile
+				decompile_task->in_progress = true;
 			}
+
+			if (decompile_task->is_fp)
+			{
+				search_fragment_program(decompile_task->fp);
+			}
+			else
+			{
+				search_vertex_program(decompile_task->vp);
+			}
+
+			decompiled = true;
+
+			std::lock_guard lock(m_decompiler_mutex);
+			m_decompile_queue.remove_if([&](const async_decompile_task_entry& task) { return &task == decompile_task; });
 		}
 
-		async_link_task_entry* link_entry;
+		async_link_task_entry* link_entry = nullptr;
 		pipeline_key key;
 		{
-			reader_lock lock(m_pipeline_mutex);
-			if (!m_link_queue.empty())
+			std::lock_guard lock(m_pipeline_mutex);
+
+			for (auto& [queued_key, entry] : m_link_queue)
 			{
-				auto It = m_link_queue.begin();
-				link_entry = It->second.get();
-				key = It->first;
+				if (!entry->in_progress && (!link_entry || entry->priority > link_entry->priority))
+				{
+					link_entry = entry.get();
+					key = queued_key;
+				}
 			}
-			else
+
+			if (!link_entry)
 			{
-				return { busy, false };
+				return { busy, decompiled, false };
 			}
+
+			link_entry->in_progress = true;
 		}
 
 		pipeline_storage_type pipeline = backend_traits::build_pipeline(link_entry->vp, link_entry->fp, link_entry->props, std::forward<Args>(args)...);
@@ -395,7 +558,7 @@ public:
 		m_storage[key] = std::move(pipeline);
 		m_link_queue.erase(key);
 
-		return { (busy || !m_link_queue.empty()), true };
+		return { (busy || !m_link_queue.empty()), decompiled, true };
 	}
 
 	template<typename... Args>
@@ -425,11 +588,16 @@ public:
 			backend_traits::validate_pipeline_properties(vertex_program, fragment_program, pipelineProperties);
 			pipeline_key key = { vertex_program.id, fragment_program.id, pipelineProperties };
 
-			const auto I = m_storage.find(key);
-			if (I != m_storage.end())
 			{
-				m_cache_miss_flag = false;
-				return I->second;
+				// Pipelines can be added concurrently by the shader cache loader
+				reader_lock lock(m_pipeline_mutex);
+
+				const auto I = m_storage.find(key);
+				if (I != m_storage.end())
+				{
+					m_cache_miss_flag = false;
+					return I->second;
+				}
 			}
 
 			if (allow_async)
@@ -452,29 +620,33 @@ public:
 
 		verify(HERE), allow_async;
 
+		// Most recently requested tasks are processed first, this favors the programs needed by the current frame
+		const u64 priority = ++m_request_count;
+
 		if (link_only)
 		{
 			const vertex_program_type &vertex_program = std::get<0>(vp_search);
 			const fragment_program_type &fragment_program = std::get<0>(fp_search);
 			pipeline_key key = { vertex_program.id, fragment_program.id, pipelineProperties };
 
-			reader_lock lock(m_pipeline_mutex);
+			std::lock_guard lock(m_pipeline_mutex);
 
-			if (m_link_queue.find(key) != m_link_queue.end())
+			if (const auto found = m_link_queue.find(key); found != m_link_queue.end())
 			{
 				// Already in queue
+				found->second->priority = priority;
 				return __null_pipeline_handle;
 			}
 
 			LOG_NOTICE(RSX, "Add program (vp id = %d, fp id = %d)", vertex_program.id, fragment_program.id);
 			m_program_compiled_flag = true;
 
-			lock.upgrade();
-			m_link_queue[key] = std::make_unique<async_link_task_entry>(vertex_program, fragment_program, pipelineProperties);
+			auto& entry = m_link_queue[key] = std::make_unique<async_link_task_entry>(vertex_program, fragment_program, pipelineProperties);
+			entry->priority = priority;
 		}
 		else
 		{
-			reader_lock lock(m_decompiler_mutex);
+			std::lock_guard lock(m_decompiler_mutex);
 
 			auto vertex_program_found = std::find_if(m_decompile_queue.begin(), m_decompile_queue.end(), [&](const auto& V)
 			{
@@ -488,19 +660,23 @@ public:
 				return program_hash_util::fragment_program_compare()(F.fp, fragmentShader);
 			});
 
-			const bool add_vertex_program = (vertex_program_found == m_decompile_queue.end());
-			const bool add_fragment_program = (fragment_program_found == m_decompile_queue.end());
-
-			if (add_vertex_program)
+			// Entries are kept in the queue while being decompiled, so in-flight requests are not added twice
+			if (vertex_program_found == m_decompile_queue.end())
 			{
-				lock.upgrade();
-				m_decompile_queue.emplace_back(vertexShader);
+				m_decompile_queue.emplace_back(vertexShader).priority = priority;
+			}
+			else
+			{
+				vertex_program_found->priority = priority;
 			}
 
-			if (add_fragment_program)
+			if (fragment_program_found == m_decompile_queue.end())
 			{
-				lock.upgrade();
-				m_decompile_queue.emplace_back(fragmentShader);
+				m_decompile_queue.emplace_back(fragmentShader).priority = priority;
+			}
+			else
+			{
+				fragment_program_found->priority = priority;
 			}
 		}
 
@@ -710,9 +710,40 @@ void GLGSRender::on_init_thread()
 	// This allows context sharing to work (both GLRCs passed to wglShareLists have to be idle or you get ERROR_BUSY)
 	m_context = m_frame->make_context();
 
-	if (!g_cfg.video.disable_asynchronous_shader_compiler)
+	m_decompiler_contexts.resize(get_decompiler_thread_count());
+
+	for (auto& ctx : m_decompiler_contexts)
 	{
-		m_decompiler_context = m_frame->make_context();
+		ctx = m_frame->make_context();
+	}
+
+	if (!g_cfg.video.disable_on_disk_shader_cache)
+	{
+		// Shared contexts for the shader cache loader threads, released when each worker is done
+		const u32 nb_workers = std::clamp(std::thread::hardware_concurrency(), 1u, 8u);
+		m_shader_load_contexts.resize(nb_workers);
+
+		for (auto& ctx : m_shader_load_contexts)
+		{
+			ctx = m_frame->make_context();
+		}
+
+		m_shaders_cache->set_workers(nb_workers, [this](u32 index)
+		{
+			m_frame->set_current(m_shader_load_contexts[index]);
+		},
+		[](u32)
+		{
+			// Shaders must be complete before they are linked from another context
+			glFinish();
+		},
+		[this](u32 index)
+		{
+			// Objects must be complete before they are used from another context
+			glFinish();
+			m_frame->delete_context(m_shader_load_contexts[index]);
+			m_shader_load_contexts[index] = nullptr;
+		});
 	}
 
 	// Bind primary context to main RSX thread
@@ -937,10 +968,16 @@ void GLGSRender::on_init_thread()
 	m_gl_texture_cache.initialize();
 	m_thread_id = std::this_thread::get_id();
 
+	if (const std::string pipeline_path = m_shaders_cache->get_pipeline_path(); !pipeline_path.empty())
+	{
+		// Driver program binaries, keyed by vendor, renderer and driver version
+		m_program_binaries.open(pipeline_path + "driver-" + gl::program_binary_cache::get_driver_id() + ".bin");
+	}
+
 	if (!supports_native_ui)
 	{
 		m_frame->hide();
-		m_shaders_cache->load(nullptr);
+		m_shaders_cache->load(nullptr, &m_program_binaries);
 		m_frame->show();
 	}
 	else
@@ -1000,7 +1037,25 @@ void GLGSRender::on_init_thread()
 		}
 		helper(this);
 
-		m_shaders_cache->load(&helper);
+		m_shaders_cache->load(&helper, &m_program_binaries);
+	}
+
+	if (!m_shader_load_contexts.empty())
+	{
+		// Release the contexts of workers which never ran (nothing to load)
+		for (auto& ctx : m_shader_load_contexts)
+		{
+			if (ctx)
+			{
+				m_frame->delete_context(ctx);
+			}
+		}
+
+		m_shader_load_contexts.clear();
+		m_shaders_cache->set_workers(0, nullptr, nullptr, nullptr);
+
+		// Deleting a context unbinds the current one
+		m_frame->set_current(m_context);
 	}
 }
 
@@ -1301,7 +1356,7 @@ bool GLGSRender::load_program()
 
 	void* pipeline_properties = nullptr;
 	m_program = m_prog_buffer.get_graphics_pipeline(current_vertex_program, current_fragment_program, pipeline_properties,
-			!g_cfg.video.disable_asynchronous_shader_compiler).get();
+			!g_cfg.video.disable_asynchronous_shader_compiler, &m_program_binaries).get();
 
 	if (m_prog_buffer.check_cache_missed())
 	{
@@ -2000,27 +2055,33 @@ void GLGSRender::discard_occlusion_query(rsx::reports::occlusion_query_info* que
 	}
 }
 
-void GLGSRender::on_decompiler_init()
+void GLGSRender::on_decompiler_init(u32 index)
 {
 	// Bind decompiler context to this thread
-	m_frame->set_current(m_decompiler_context);
+	m_frame->set_current(m_decompiler_contexts[index]);
 }
 
-void GLGSRender::on_decompiler_exit()
+void GLGSRender::on_decompiler_exit(u32 index)
 {
 	// Cleanup
-	m_frame->delete_context(m_decompiler_context);
+	m_frame->delete_context(m_decompiler_contexts[index]);
+}
+
+std::pair<u32, u32> GLGSRender::get_shader_queue_depth()
+{
+	return m_prog_buffer.get_async_queue_depth();
 }
 
 bool GLGSRender::on_decompiler_task()
 {
-	const auto result = m_prog_buffer.async_update(8);
-	if (result.second)
+	const auto result = m_prog_buffer.async_update(8, &m_program_binaries);
+	if (result.linked || (result.decompiled && m_decompiler_contexts.size() > 1))
 	{
 		// TODO: Proper synchronization with renderer
 		// Finish works well enough for now but it is not a proper soulution
+		// Shaders decompiled here may be linked by another worker context, so they must be complete as well
 		glFinish();
 	}
 
-	return result.first;
+	return result.busy;
 }
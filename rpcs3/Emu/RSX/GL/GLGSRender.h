@@ -331,7 +331,9 @@ private:
 	std::thread::id m_thread_id;
 
 	GLProgramBuffer m_prog_buffer;
-	draw_context_t m_decompiler_context;
+	gl::program_binary_cache m_program_binaries;
+	std::vector<draw_context_t> m_decompiler_contexts;
+	std::vector<draw_context_t> m_shader_load_contexts;
 
 	//buffer
 	gl::fbo* m_draw_fbo = nullptr;
@@ -404,7 +406,10 @@ protected:
 	std::array<std::vector<gsl::byte>, 4> copy_render_targets_to_memory() override;
 	std::array<std::vector<gsl::byte>, 2> copy_depth_stencil_buffer_to_memory() override;
 
-	void on_decompiler_init() override;
-	void on_decompiler_exit() override;
+	void on_decompiler_init(u32 index) override;
+	void on_decompiler_exit(u32 index) override;
 	bool on_decompiler_task() override;
+
+public:
+	std::pair<u32, u32> get_shader_queue_depth() override;
 };
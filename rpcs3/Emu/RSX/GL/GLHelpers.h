@@ -105,6 +105,7 @@ namespace gl
 		bool NV_texture_barrier_supported = false;
 		bool NV_gpu_shader5_supported = false;
 		bool AMD_gpu_shader_half_float_supported = false;
+		bool ARB_get_program_binary_supported = false;
 		bool initialized = false;
 		bool vendor_INTEL = false;  // has broken GLSL compiler
 		bool vendor_AMD = false;    // has broken ARB_multidraw
@@ -124,7 +125,7 @@ namespace gl
 
 		void initialize()
 		{
-			int find_count = 10;
+			int find_count = 11;
 			int ext_count = 0;
 			glGetIntegerv(GL_NUM_EXTENSIONS, &ext_count);
 
@@ -203,6 +204,13 @@ namespace gl
 					find_count--;
 					continue;
 				}
+
+				if (check(ext_name, "GL_ARB_get_program_binary"))
+				{
+					ARB_get_program_binary_supported = true;
+					find_count--;
+					continue;
+				}
 			}
 
 			// Workaround for intel drivers which have terrible capability reporting
@@ -2711,6 +2719,39 @@ public:
 				link();
 			}
 
+			// Must be set before linking for the binary to be retrievable
+			program& set_binary_retrievable()
+			{
+				glProgramParameteri(m_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+				return *this;
+			}
+
+			// Link from a binary previously returned by get_binary, fails if the driver rejects it
+			bool load_binary(GLenum format, const void* data, GLsizei size)
+			{
+				glProgramBinary(m_id, format, data, size);
+
+				GLint status = GL_FALSE;
+				glGetProgramiv(m_id, GL_LINK_STATUS, &status);
+				return status == GL_TRUE;
+			}
+
+			std::vector<u8> get_binary(GLenum& format) const
+			{
+				GLint length = 0;
+				glGetProgramiv(m_id, GL_PROGRAM_BINARY_LENGTH, &length);
+
+				std::vector<u8> result(length);
+
+				if (length)
+				{
+					glGetProgramBinary(m_id, length, &length, &format, result.data());
+					result.resize(length);
+				}
+
+				return result;
+			}
+
 			uint id() const
 			{
 				return m_id;
@@ -29,6 +29,9 @@ OPENGL_PROC(PFNGLBINDATTRIBLOCATIONPROC, BindAttribLocation);
 OPENGL_PROC(PFNGLGETUNIFORMLOCATIONPROC, GetUniformLocation);
 OPENGL_PROC(PFNGLGETPROGRAMIVPROC, GetProgramiv);
 OPENGL_PROC(PFNGLGETPROGRAMINFOLOGPROC, GetProgramInfoLog);
+OPENGL_PROC(PFNGLGETPROGRAMBINARYPROC, GetProgramBinary);
+OPENGL_PROC(PFNGLPROGRAMBINARYPROC, ProgramBinary);
+OPENGL_PROC(PFNGLPROGRAMPARAMETERIPROC, ProgramParameteri);
 OPENGL_PROC(PFNGLVERTEXATTRIBPOINTERPROC, VertexAttribPointer);
 OPENGL_PROC(PFNGLENABLEVERTEXATTRIBARRAYPROC, EnableVertexAttribArray);
 OPENGL_PROC(PFNGLDISABLEVERTEXATTRIBARRAYPROC, DisableVertexAttribArray);
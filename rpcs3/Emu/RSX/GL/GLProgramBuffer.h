@@ -4,6 +4,175 @@
 #include "GLHelpers.h"
 #include "../Common/ProgramStateCache.h"
 
+namespace gl
+{
+	// Linked program binaries (ARB_get_program_binary) persisted for a single driver
+	// Programs are keyed by their shader sources, the file is append-only: header followed by records
+	class program_binary_cache
+	{
+		struct record_header
+		{
+			u64 key;
+			u32 format;
+			u32 size;
+		};
+
+		static constexpr u64 file_magic = 0x4e4942474c435052ull; // "RPCLGBIN"
+
+		fs::file m_file;
+		std::string m_path;
+		shared_mutex m_mutex;
+		std::unordered_map<u64, std::pair<GLenum, std::vector<u8>>> m_binaries;
+
+	public:
+		// FNV 64-bit over both shader sources
+		static u64 get_key(const std::string& vertex_shader, const std::string& fragment_shader)
+		{
+			u64 result = 14695981039346656037ull;
+
+			for (const std::string* str : { &vertex_shader, &fragment_shader })
+			{
+				for (char c : *str)
+				{
+					result ^= u8(c);
+					result *= 1099511628211ull;
+				}
+
+				result ^= 0xff;
+				result *= 1099511628211ull;
+			}
+
+			return result;
+		}
+
+		// Driver identity used to name the file, binaries are not portable across drivers
+		static std::string get_driver_id()
+		{
+			std::string id;
+
+			for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION })
+			{
+				if (const auto str = reinterpret_cast<const char*>(glGetString(name)))
+				{
+					id += str;
+				}
+
+				id += '\n';
+			}
+
+			return fmt::format("%016llx", get_key(id, {}));
+		}
+
+		void open(const std::string& path)
+		{
+			std::lock_guard lock(m_mutex);
+
+			GLint formats = 0;
+			glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+
+			if (!get_driver_caps().ARB_get_program_binary_supported || formats <= 0)
+			{
+				LOG_NOTICE(RSX, "Program binaries are not supported by the driver");
+				return;
+			}
+
+			if (!m_file.open(path, fs::read + fs::write + fs::create + fs::append))
+			{
+				LOG_ERROR(RSX, "Failed to open program binary cache %s (%s)", path, fs::g_tls_error);
+				return;
+			}
+
+			m_path = path;
+
+			const auto data = m_file.to_vector<u8>();
+
+			if (data.size() < sizeof(u64) || std::memcmp(data.data(), &file_magic, sizeof(u64)) != 0)
+			{
+				m_file.trunc(0);
+				m_file.write(&file_magic, sizeof(u64));
+				return;
+			}
+
+			u64 pos = sizeof(u64);
+
+			while (pos + sizeof(record_header) <= data.size())
+			{
+				record_header rec;
+				std::memcpy(&rec, data.data() + pos, sizeof(record_header));
+
+				if (rec.size > data.size() - pos - sizeof(record_header))
+				{
+					break;
+				}
+
+				const u8* payload = data.data() + pos + sizeof(record_header);
+				m_binaries[rec.key] = { rec.format, std::vector<u8>(payload, payload + rec.size) };
+				pos += sizeof(record_header) + rec.size;
+			}
+
+			if (pos != data.size())
+			{
+				// Recover from interrupted write by dropping the incomplete tail
+				LOG_WARNING(RSX, "Program binary cache %s: discarding %u bytes of incomplete data", path, data.size() - pos);
+				m_file.trunc(pos);
+			}
+
+			LOG_NOTICE(RSX, "Loaded %u program binaries", m_binaries.size());
+		}
+
+		bool enabled() const
+		{
+			return !!m_file;
+		}
+
+		// Link the program from a stored binary, returns false if there is none or the driver rejected it
+		bool load(glsl::program& prog, u64 key)
+		{
+			reader_lock lock(m_mutex);
+
+			const auto found = m_binaries.find(key);
+
+			if (found == m_binaries.end())
+			{
+				return false;
+			}
+
+			const auto& [format, binary] = found->second;
+
+			if (!prog.load_binary(format, binary.data(), ::narrow<GLsizei>(binary.size())))
+			{
+				LOG_WARNING(RSX, "Program binary 0x%llx was rejected by the driver", key);
+				return false;
+			}
+
+			return true;
+		}
+
+		// Store the binary of a program linked with set_binary_retrievable()
+		void store(const glsl::program& prog, u64 key)
+		{
+			GLenum format = GL_NONE;
+			std::vector<u8> binary = prog.get_binary(format);
+
+			if (binary.empty())
+			{
+				return;
+			}
+
+			std::vector<u8> buffer(sizeof(record_header) + binary.size());
+			const record_header rec{key, format, ::size32(binary)};
+			std::memcpy(buffer.data(), &rec, sizeof(record_header));
+			std::memcpy(buffer.data() + sizeof(record_header), binary.data(), binary.size());
+
+			std::lock_guard lock(m_mutex);
+
+			// A rejected binary is replaced by a newer record with the same key
+			m_binaries[key] = { format, std::move(binary) };
+			m_file.write(buffer.data(), buffer.size());
+		}
+	};
+}
+
 struct GLTraits
 {
 	using vertex_program_type = GLVertexProgram;
@@ -31,17 +200,36 @@ struct GLTraits
 	}
 
 	static
-	pipeline_storage_type build_pipeline(const vertex_program_type &vertexProgramData, const fragment_program_type &fragmentProgramData, const pipeline_properties&)
+	pipeline_storage_type build_pipeline(const vertex_program_type &vertexProgramData, const fragment_program_type &fragmentProgramData, const pipeline_properties&,
+			gl::program_binary_cache* binaries = nullptr)
 	{
 		pipeline_storage_type result = std::make_unique<gl::glsl::program>();
-		result->create()
-			.attach(gl::glsl::shader_view(vertexProgramData.id))
-			.attach(gl::glsl::shader_view(fragmentProgramData.id))
-			.bind_fragment_data_location("ocol0", 0)
-			.bind_fragment_data_location("ocol1", 1)
-			.bind_fragment_data_location("ocol2", 2)
-			.bind_fragment_data_location("ocol3", 3)
-			.make();
+		result->create();
+
+		const bool use_binaries = binaries && binaries->enabled();
+		const u64 binary_key = use_binaries ? gl::program_binary_cache::get_key(vertexProgramData.shader, fragmentProgramData.shader) : 0;
+
+		// The driver compile is skipped when a binary of the same program is available
+		if (!use_binaries || !binaries->load(*result, binary_key))
+		{
+			if (use_binaries)
+			{
+				result->set_binary_retrievable();
+			}
+
+			result->attach(gl::glsl::shader_view(vertexProgramData.id))
+				.attach(gl::glsl::shader_view(fragmentProgramData.id))
+				.bind_fragment_data_location("ocol0", 0)
+				.bind_fragment_data_location("ocol1", 1)
+				.bind_fragment_data_location("ocol2", 2)
+				.bind_fragment_data_location("ocol3", 3)
+				.make();
+
+			if (use_binaries)
+			{
+				binaries->store(*result, binary_key);
+			}
+		}
 
 		// Progam locations are guaranteed to not change after linking
 		// Texture locations are simply bound to the TIUs so this can be done once
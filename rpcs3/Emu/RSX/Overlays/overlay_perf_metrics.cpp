@@ -115,7 +115,7 @@ namespace rsx
 			case detail_level::minimal:
 			case detail_level::low: m_titles.text = ""; break;
 			case detail_level::medium: m_titles.text = fmt::format("\n\n%s", title1_medium); break;
-			case detail_level::high: m_titles.text = fmt::format("\n\n%s\n\n\n\n\n\n%s", title1_high, title2); break;
+			case detail_level::high: m_titles.text = fmt::format("\n\n%s\n\n\n\n\n\n%s\n\n\n\n\n%s", title1_high, title2, title3); break;
 			}
 			m_titles.auto_resize();
 			m_titles.refresh();
@@ -243,6 +243,10 @@ namespace rsx
 				f32 spu_usage{0};
 				f32 rsx_usage{0};
 				u32 rsx_load{0};
+				std::pair<u32, u32> shader_queue{};
+
+				// Stall percentages of guest thread time since last update
+				f32 stall_usage[static_cast<u32>(cpu_stall::__max)]{};
 
 				std::shared_ptr<GSRender> rsx_thread;
 
@@ -257,9 +261,28 @@ namespace rsx
 
 					rsx_thread = fxm::get<GSRender>();
 					rsx_load = rsx_thread->get_load();
+					shader_queue = rsx_thread->get_shader_queue_depth();
 
 					total_threads = CPUStats::get_thread_count();
 
+					u64 stall_ticks[static_cast<u32>(cpu_stall::__max)];
+					u64 total_ticks;
+
+					cpu_thread::get_stall_totals(stall_ticks, &total_ticks);
+
+					// Totals can decrease when threads exit
+					const u64 total_diff = total_ticks > m_total_ticks ? total_ticks - m_total_ticks : 0;
+
+					for (u32 i = 0; i < static_cast<u32>(cpu_stall::__max); i++)
+					{
+						const u64 diff = stall_ticks[i] > m_stall_ticks[i] ? stall_ticks[i] - m_stall_ticks[i] : 0;
+
+						stall_usage[i] = total_diff ? std::clamp(100.f * diff / total_diff, 0.f, 100.f) : 0.f;
+						m_stall_ticks[i] = stall_ticks[i];
+					}
+
+					m_total_ticks = total_ticks;
+
 					// fallthrough
 				}
 				case detail_level::medium:
@@ -336,8 +359,21 @@ namespace rsx
 					                         " RSX   : %04.1f %% ( 1)\n"
 					                         " Total : %04.1f %% (%2u)\n\n"
 					                         "%s\n"
-					                         " RSX   : %02u %%",
-					    fps, frametime, std::string(title1_high.size(), ' '), ppu_usage, ppus, spu_usage, spus, rsx_usage, cpu_usage, total_threads, std::string(title2.size(), ' '), rsx_load);
+					                         " RSX   : %02u %%\n"
+					                         " ShdDec: %3u\n"
+					                         " ShdLnk: %3u\n\n"
+					                         "%s\n"
+					                         " Sleep : %04.1f %%\n"
+					                         " Pause : %04.1f %%\n"
+					                         " Mem   : %04.1f %%\n"
+					                         " Chan  : %04.1f %%",
+					    fps, frametime, std::string(title1_high.size(), ' '), ppu_usage, ppus, spu_usage, spus, rsx_usage, cpu_usage, total_threads, std::string(title2.size(), ' '), rsx_load,
+					    shader_queue.first, shader_queue.second,
+					    std::string(title3.size(), ' '),
+					    stall_usage[static_cast<u32>(cpu_stall::suspend)],
+					    stall_usage[static_cast<u32>(cpu_stall::pause)],
+					    stall_usage[static_cast<u32>(cpu_stall::memory)],
+					    stall_usage[static_cast<u32>(cpu_stall::channel)]);
 					break;
 				}
 				}
@@ -6,6 +6,7 @@
 #include "../../Io/PadHandler.h"
 #include "Emu/Memory/vm.h"
 #include "Emu/IdManager.h"
+#include "Emu/CPU/CPUThread.h"
 #include "pad_thread.h"
 
 #include "Emu/Cell/ErrorCodes.h"
@@ -342,6 +343,11 @@ namespace rsx
 
 			CPUStats m_cpu_stats;
 			Timer m_update_timer;
+
+			// Previous stall totals of guest threads (TSC ticks)
+			u64 m_stall_ticks[static_cast<u32>(cpu_stall::__max)]{};
+			u64 m_total_ticks{0};
+
 			u32 m_update_interval; // in ms
 			u32 m_frames{ 0 };
 			std::string m_font;
@@ -356,6 +362,7 @@ namespace rsx
 			const std::string title1_medium{"CPU Utilization:"};
 			const std::string title1_high{"Host Utilization (CPU):"};
 			const std::string title2{"Guest Utilization (PS3):"};
+			const std::string title3{"Guest Stalls (PPU+SPU):"};
 
 			void reset_transform(label& elm) const;
 			void reset_transforms();
@@ -482,38 +482,35 @@ namespace rsx
 			}
 		});
 
-		thread_ctrl::spawn("RSX Decompiler Thread", [this]
+		for (u32 index = 0; index < get_decompiler_thread_count(); index++)
 		{
-			if (g_cfg.video.disable_asynchronous_shader_compiler)
+			thread_ctrl::spawn(fmt::format("RSX Decompiler Thread %u", index), [this, index]
 			{
-				// Die
-				return;
-			}
+				on_decompiler_init(index);
 
-			on_decompiler_init();
-
-			if (g_cfg.core.thread_scheduler_enabled)
-			{
-				thread_ctrl::set_thread_affinity_mask(thread_ctrl::get_affinity_mask(thread_class::rsx));
-			}
+				if (g_cfg.core.thread_scheduler_enabled)
+				{
+					thread_ctrl::set_thread_affinity_mask(thread_ctrl::get_affinity_mask(thread_class::rsx));
+				}
 
-			while (!Emu.IsStopped() && !m_rsx_thread_exiting)
-			{
-				if (!on_decompiler_task())
+				while (!Emu.IsStopped() && !m_rsx_thread_exiting)
 				{
-					if (Emu.IsPaused())
-					{
-						std::this_thread::sleep_for(1ms);
-					}
-					else
+					if (!on_decompiler_task())
 					{
-						std::this_thread::sleep_for(500us);
+						if (Emu.IsPaused())
+						{
+							std::this_thread::sleep_for(1ms);
+						}
+						else
+						{
+							std::this_thread::sleep_for(500us);
+						}
 					}
 				}
-			}
 
-			on_decompiler_exit();
-		});
+				on_decompiler_exit(index);
+			});
+		}
 
 		// Raise priority above other threads
 		thread_ctrl::set_native_priority(1);
@@ -2353,6 +2350,22 @@ namespace rsx
 		external_interrupt_lock.store(false);
 	}
 
+	u32 thread::get_decompiler_thread_count()
+	{
+		if (g_cfg.video.disable_asynchronous_shader_compiler)
+		{
+			return 0;
+		}
+
+		if (const u32 count = g_cfg.video.shader_compiler_threads)
+		{
+			return count;
+		}
+
+		// Leave most of the cores to the guest threads
+		return std::clamp(std::thread::hardware_concurrency() / 4, 1u, 4u);
+	}
+
 	u32 thread::get_load()
 	{
 		//Average load over around 30 frames
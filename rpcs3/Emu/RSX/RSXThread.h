@@ -608,8 +608,9 @@ namespace rsx
 		 */
 		virtual void do_local_task(FIFO_state state);
 
-		virtual void on_decompiler_init() {}
-		virtual void on_decompiler_exit() {}
+		// Called on each of the get_decompiler_thread_count() decompiler threads
+		virtual void on_decompiler_init(u32 /*index*/) {}
+		virtual void on_decompiler_exit(u32 /*index*/) {}
 		virtual bool on_decompiler_task() { return false; }
 
 		virtual void emit_geometry(u32) {}
@@ -794,5 +795,11 @@ namespace rsx
 
 		//Get RSX approximate load in %
 		u32 get_load();
+
+		// Number of asynchronous shader compiler threads (0 if disabled)
+		static u32 get_decompiler_thread_count();
+
+		// Pending decompile and link tasks of the asynchronous shader compiler
+		virtual std::pair<u32, u32> get_shader_queue_depth() { return {}; }
 	};
 }
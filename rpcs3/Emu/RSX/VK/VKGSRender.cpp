@@ -541,6 +541,12 @@ VKGSRender::VKGSRender() : GSRender()
 
 	m_shaders_cache = std::make_unique<vk::shader_cache>(*m_prog_buffer, "vulkan", "v1.8");
 
+	if (const std::string pipeline_path = m_shaders_cache->get_pipeline_path(); !pipeline_path.empty())
+	{
+		// Driver pipeline binaries are keyed by device and pipeline cache UUID
+		vk::load_pipeline_cache(pipeline_path + "driver-" + m_device->gpu().get_pipeline_cache_id() + ".bin");
+	}
+
 	open_command_buffer();
 
 	for (u32 i = 0; i < m_swapchain->get_swap_image_count(); ++i)
@@ -583,6 +589,7 @@ VKGSRender::~VKGSRender()
 	m_texture_cache.destroy();
 
 	//Shaders
+	vk::save_pipeline_cache();
 	vk::finalize_compiler_context();
 	m_prog_buffer->clear();
 
@@ -1841,6 +1848,9 @@ void VKGSRender::on_init_thread()
 		// TODO: Handle window resize messages during loading on GPUs without OUT_OF_DATE_KHR support
 		m_shaders_cache->load(&helper, *m_device, pipeline_layout);
 	}
+
+	// Persist binaries of the preloaded pipelines early in case the emulator does not exit cleanly
+	vk::save_pipeline_cache();
 }
 
 void VKGSRender::on_exit()
@@ -3496,7 +3506,12 @@ void VKGSRender::discard_occlusion_query(rsx::reports::occlusion_query_info* que
 	m_occlusion_map.erase(query->driver_handle);
 }
 
+std::pair<u32, u32> VKGSRender::get_shader_queue_depth()
+{
+	return m_prog_buffer->get_async_queue_depth();
+}
+
 bool VKGSRender::on_decompiler_task()
 {
-	return m_prog_buffer->async_update(8, *m_device, pipeline_layout).first;
+	return m_prog_buffer->async_update(8, *m_device, pipeline_layout).busy;
 }
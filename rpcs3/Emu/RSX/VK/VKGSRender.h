@@ -547,4 +547,7 @@ protected:
 	void on_invalidate_memory_range(const utils::address_range &range) override;
 
 	bool on_decompiler_task() override;
+
+public:
+	std::pair<u32, u32> get_shader_queue_depth() override;
 };
@@ -22,6 +22,9 @@ namespace vk
 
 	VkSampler g_null_sampler = nullptr;
 
+	VkPipelineCache g_pipeline_cache = VK_NULL_HANDLE;
+	std::string g_pipeline_cache_path;
+
 	atomic_t<bool> g_cb_no_interrupt_flag { false };
 
 	// Driver compatibility workarounds
@@ -267,6 +270,105 @@ namespace vk
 		}
 
 		g_compute_tasks.clear();
+
+		if (g_pipeline_cache)
+		{
+			vkDestroyPipelineCache(dev, g_pipeline_cache, nullptr);
+			g_pipeline_cache = VK_NULL_HANDLE;
+		}
+	}
+
+	void load_pipeline_cache(const std::string& path)
+	{
+		const VkDevice dev = *g_current_renderer;
+		const auto& props = g_current_renderer->gpu().get_properties();
+
+		std::vector<u8> data;
+
+		if (fs::file cache_file{path})
+		{
+			data = cache_file.to_vector<u8>();
+		}
+
+		// Header version one: length, version, vendor ID, device ID, pipeline cache UUID
+		u32 header[4]{};
+
+		if (data.size() >= sizeof(header) + VK_UUID_SIZE)
+		{
+			std::memcpy(header, data.data(), sizeof(header));
+		}
+
+		if (header[1] != VK_PIPELINE_CACHE_HEADER_VERSION_ONE || header[2] != props.vendorID || header[3] != props.deviceID ||
+			std::memcmp(data.data() + sizeof(header), props.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+		{
+			if (!data.empty())
+			{
+				LOG_WARNING(RSX, "Pipeline cache %s is not compatible with the current driver", path);
+			}
+
+			data.clear();
+		}
+
+		VkPipelineCacheCreateInfo info = {};
+		info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+		info.initialDataSize = data.size();
+		info.pInitialData = data.data();
+
+		if (vkCreatePipelineCache(dev, &info, nullptr, &g_pipeline_cache) != VK_SUCCESS)
+		{
+			LOG_ERROR(RSX, "Failed to create pipeline cache");
+			g_pipeline_cache = VK_NULL_HANDLE;
+			return;
+		}
+
+		g_pipeline_cache_path = path;
+		LOG_NOTICE(RSX, "Pipeline cache loaded (%u bytes)", data.size());
+	}
+
+	void save_pipeline_cache()
+	{
+		if (!g_pipeline_cache || g_pipeline_cache_path.empty())
+		{
+			return;
+		}
+
+		const VkDevice dev = *g_current_renderer;
+
+		size_t size = 0;
+		std::vector<u8> data;
+
+		if (vkGetPipelineCacheData(dev, g_pipeline_cache, &size, nullptr) != VK_SUCCESS || !size)
+		{
+			return;
+		}
+
+		data.resize(size);
+
+		if (vkGetPipelineCacheData(dev, g_pipeline_cache, &size, data.data()) != VK_SUCCESS)
+		{
+			LOG_ERROR(RSX, "Failed to get pipeline cache data");
+			return;
+		}
+
+		// Written to a temporary file first so that an interrupted write cannot corrupt the cache
+		const std::string tmp_path = g_pipeline_cache_path + ".tmp";
+
+		bool written = false;
+
+		if (fs::file tmp_file{tmp_path, fs::rewrite})
+		{
+			written = tmp_file.write(data.data(), size) == size;
+		}
+
+		if (!written || !fs::rename(tmp_path, g_pipeline_cache_path, true))
+		{
+			LOG_ERROR(RSX, "Failed to save pipeline cache %s (%s)", g_pipeline_cache_path, fs::g_tls_error);
+		}
+	}
+
+	VkPipelineCache get_pipeline_cache()
+	{
+		return g_pipeline_cache;
 	}
 
 	vk::mem_allocator_base* get_current_mem_allocator()
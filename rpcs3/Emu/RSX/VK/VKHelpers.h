@@ -133,6 +133,11 @@ namespace vk
 	void reset_compute_tasks();
 
 	void destroy_global_resources();
+
+	// Driver pipeline cache, loaded from and saved to the given file
+	void load_pipeline_cache(const std::string& path);
+	void save_pipeline_cache();
+	VkPipelineCache get_pipeline_cache();
 	void reset_global_resources();
 
 	/**
@@ -487,6 +492,23 @@ namespace vk
 			}
 		}
 
+		// Identifies the driver for pipeline cache compatibility
+		std::string get_pipeline_cache_id() const
+		{
+			std::string uuid;
+			for (u8 byte : props.pipelineCacheUUID)
+			{
+				uuid += fmt::format("%02x", byte);
+			}
+
+			return fmt::format("%04x-%04x-%s", props.vendorID, props.deviceID, uuid);
+		}
+
+		const VkPhysicalDeviceProperties& get_properties() const
+		{
+			return props;
+		}
+
 		uint32_t get_queue_count() const
 		{
 			if (!queue_props.empty())
@@ -167,7 +167,7 @@ struct VKTraits
 		info.basePipelineHandle = VK_NULL_HANDLE;
 		info.renderPass = vk::get_renderpass(dev, pipelineProperties.renderpass_key);
 
-		CHECK_RESULT(vkCreateGraphicsPipelines(dev, nullptr, 1, &info, NULL, &pipeline));
+		CHECK_RESULT(vkCreateGraphicsPipelines(dev, vk::get_pipeline_cache(), 1, &info, NULL, &pipeline));
 
 		pipeline_storage_type result = std::make_unique<vk::glsl::program>(dev, pipeline, vertexProgramData.uniforms, fragmentProgramData.uniforms);
 		result->link();
@@ -8,8 +8,13 @@
 #include "Emu/System.h"
 #include "Common/texture_cache_checker.h"
 
+#include "Utilities/mutex.h"
+
 #include "rsx_utils.h"
 #include <thread>
+#include <optional>
+#include <functional>
+#include <unordered_set>
 
 namespace rsx
 {
@@ -411,11 +416,52 @@ namespace rsx
 			pipeline_storage_type pipeline_properties;
 		};
 
+		// Packed cache file: pack_header followed by append-only records (pack_record + payload)
+		struct pack_header
+		{
+			u64 magic;
+			u32 version;
+			u32 pipeline_size;
+		};
+
+		struct pack_record
+		{
+			u32 type;
+			u32 size;
+			u64 key;
+			u64 checksum;
+		};
+
+		enum pack_record_type : u32
+		{
+			pack_vertex_program = 1,
+			pack_fragment_program = 2,
+			pack_pipeline = 3,
+		};
+
+		static constexpr u64 pack_magic = 0x4b43415053435052ull; // "RPCSPACK"
+		static constexpr u32 pack_version = 1;
+
 		std::string version_prefix;
 		std::string root_path;
 		std::string pipeline_class_name;
+		std::string pack_path;
 		std::unordered_map<u64, std::vector<u8>> fragment_program_data;
 
+		// Packed cache file (opened for appending) and its index (record offsets)
+		fs::file m_pack;
+		shared_mutex m_pack_mutex;
+		std::unordered_map<u64, u64> m_vp_index;
+		std::unordered_map<u64, u64> m_fp_index;
+		std::unordered_set<u64> m_pipeline_keys;
+		std::vector<u64> m_pipeline_offsets;
+
+		// Optional worker setup for backends which need per-thread state to compile (e.g. a GL context)
+		u32 m_worker_count = 0;
+		std::function<void(u32)> m_worker_init;
+		std::function<void(u32)> m_worker_sync;
+		std::function<void(u32)> m_worker_exit;
+
 		backend_storage& m_storage;
 
 	public:
@@ -508,9 +554,26 @@ namespace rsx
 			if (!g_cfg.video.disable_on_disk_shader_cache)
 			{
 				root_path = Emu.PPUCache() + "shaders_cache";
+				pack_path = root_path + "/pipelines/" + pipeline_class_name + "/" + version_prefix + ".pack";
 			}
 		}
 
+		// Directory of this cache, used by the backends to store driver pipeline binaries (empty if disabled)
+		std::string get_pipeline_path() const
+		{
+			return root_path.empty() ? root_path : root_path + "/pipelines/" + pipeline_class_name + "/";
+		}
+
+		// Compile the cache with count worker threads, init, sync and exit are called on each worker thread with its index
+		// sync is called after the compile phase, before programs compiled by this worker are linked by others
+		void set_workers(u32 count, std::function<void(u32)> init, std::function<void(u32)> sync, std::function<void(u32)> exit)
+		{
+			m_worker_count = count;
+			m_worker_init = std::move(init);
+			m_worker_sync = std::move(sync);
+			m_worker_exit = std::move(exit);
+		}
+
 		template <typename... Args>
 		void load(progress_dialog_helper* dlg, Args&& ...args)
 		{
@@ -519,37 +582,28 @@ namespace rsx
 				return;
 			}
 
-			std::string directory_path = root_path + "/pipelines/" + pipeline_class_name + "/" + version_prefix;
-
-			if (!fs::is_dir(directory_path))
-			{
-				fs::create_path(directory_path);
-				fs::create_path(root_path + "/raw");
-
-				return;
-			}
+			fs::create_path(root_path + "/pipelines/" + pipeline_class_name);
 
-			fs::dir root = fs::dir(directory_path);
+			// Whole file is read at once, records are accessed in memory using a copy of the index
+			std::vector<u8> pack;
+			std::vector<u64> pipeline_offsets;
+			std::unordered_map<u64, u64> vp_index;
+			std::unordered_map<u64, u64> fp_index;
 
-			u32 entry_count = 0;
-			std::vector<fs::dir_entry> entries;
-			for (auto It = root.begin(); It != root.end(); ++It, entry_count++)
 			{
-				fs::dir_entry tmp = *It;
+				std::lock_guard lock(m_pack_mutex);
 
-				if (tmp.name == "." || tmp.name == "..")
-					continue;
+				pack = open_pack_import();
 
-				entries.push_back(tmp);
+				pipeline_offsets = m_pipeline_offsets;
+				vp_index = m_vp_index;
+				fp_index = m_fp_index;
 			}
 
-			if ((entry_count = (u32)entries.size()) <= 2)
-				return;
-
-			root.rewind();
+			u32 entry_count = ::size32(pipeline_offsets);
 
-			// Invalid pipeline entries to be removed
-			std::vector<std::string> invalid_entries;
+			if (!entry_count)
+				return;
 
 			// Progress dialog
 			std::unique_ptr<progress_dialog_helper> fallback_dlg;
@@ -565,63 +619,98 @@ namespace rsx
 			dlg->update_msg(0, 0, entry_count);
 			dlg->update_msg(1, 0, entry_count);
 
-			// Setup worker threads
-			unsigned nb_threads = std::thread::hardware_concurrency();
-			std::vector<std::thread> worker_threads(nb_threads);
-
-			// Preload everything needed to compile the shaders
-			// Can probably be parallelized too, but since it's mostly reading files it's probably not worth it
-			std::vector<std::tuple<pipeline_storage_type, RSXVertexProgram, RSXFragmentProgram>> unpacked;
-			std::chrono::time_point<steady_clock> last_update;
-			u32 processed_since_last_update = 0;
+			using unpacked_type = std::tuple<pipeline_storage_type, RSXVertexProgram, RSXFragmentProgram>;
 
-			for (u32 i = 0; (i < entry_count) && !Emu.IsStopped(); i++)
+			// Read a pipeline entry and preload its programs (returns nothing for invalid entries)
+			auto load_entry = [&](u32 i) -> std::optional<unpacked_type>
 			{
-				fs::dir_entry tmp = entries[i];
+				pipeline_data data;
+				std::memcpy(&data, pack.data() + pipeline_offsets[i] + sizeof(pack_record), sizeof(pipeline_data));
+
+				const auto vp = vp_index.find(data.vertex_program_hash);
+				const auto fp = fp_index.find(data.fragment_program_hash);
 
-				const auto filename = directory_path + "/" + tmp.name;
-				std::vector<u8> bytes;
-				fs::file f(filename);
-				if (f.size() != sizeof(pipeline_data))
+				if (vp == vp_index.end() || fp == fp_index.end())
 				{
-					LOG_ERROR(RSX, "Cached pipeline object %s is not binary compatible with the current shader cache", tmp.name.c_str());
-					invalid_entries.push_back(filename);
-					continue;
+					LOG_ERROR(RSX, "Cached pipeline object %llX+%llX has no program data", data.vertex_program_hash, data.fragment_program_hash);
+					return std::nullopt;
 				}
-				f.read<u8>(bytes, f.size());
 
-				auto entry = unpack(*(pipeline_data*)bytes.data());
-				m_storage.preload_programs(std::get<1>(entry), std::get<2>(entry));
-				unpacked.push_back(entry);
+				std::optional<unpacked_type> entry;
 
-				// Only update the screen at about 10fps since updating it everytime slows down the process
-				std::chrono::time_point<steady_clock> now = std::chrono::steady_clock::now();
-				processed_since_last_update++;
-				if ((std::chrono::duration_cast<std::chrono::milliseconds>(now - last_update) > 100ms) || (i == entry_count - 1))
 				{
-					dlg->update_msg(0, i + 1, entry_count);
-					dlg->inc_value(0, processed_since_last_update);
-					last_update = now;
-					processed_since_last_update = 0;
+					// unpack() inserts into fragment_program_data
+					std::lock_guard lock(m_pack_mutex);
+					entry = unpack(data, pack, vp->second, fp->second);
 				}
-			}
 
-			// Account for any invalid entries
-			entry_count = u32(unpacked.size());
+				m_storage.preload_programs(std::get<1>(*entry), std::get<2>(*entry));
+				return entry;
+			};
 
-			atomic_t<u32> processed(0);
-			std::function<void(u32)> shader_comp_worker = [&](u32 index)
+			std::chrono::time_point<steady_clock> last_update;
+			u32 processed_since_last_update = 0;
+
+			// Backends which need a context bound to each worker thread provide it through set_workers()
+			const bool custom_workers = m_worker_count && m_worker_init;
+
+			if (g_cfg.video.renderer == video_renderer::vulkan || custom_workers)
 			{
-				u32 pos;
-				while (((pos = processed++) < entry_count) && !Emu.IsStopped())
+				// Setup worker threads
+				const u32 nb_threads = custom_workers ? m_worker_count : std::thread::hardware_concurrency();
+				std::vector<std::thread> worker_threads(nb_threads);
+				std::vector<std::optional<unpacked_type>> unpacked(entry_count);
+
+				atomic_t<u32> preload_pos(0);
+				atomic_t<u32> preloaded(0);
+				atomic_t<u32> workers_ready(0);
+				atomic_t<u32> compile_pos(0);
+				atomic_t<u32> compiled(0);
+
+				// The same threads are used for both phases, a context must stay bound to a single thread
+				std::function<void(u32)> shader_comp_worker = [&](u32 index)
 				{
-					auto& entry = unpacked[pos];
-					m_storage.add_pipeline_entry(std::get<1>(entry), std::get<2>(entry), std::get<0>(entry), std::forward<Args>(args)...);
-				}
-			};
+					if (m_worker_init)
+					{
+						m_worker_init(index);
+					}
+
+					u32 pos;
+					while (((pos = preload_pos++) < entry_count) && !Emu.IsStopped())
+					{
+						unpacked[pos] = load_entry(pos);
+						preloaded++;
+					}
+
+					// Wait for all programs to be compiled before linking
+					if (m_worker_sync)
+					{
+						m_worker_sync(index);
+					}
+
+					workers_ready++;
+
+					while (workers_ready < nb_threads && !Emu.IsStopped())
+					{
+						std::this_thread::sleep_for(1ms);
+					}
+
+					while (((pos = compile_pos++) < entry_count) && !Emu.IsStopped())
+					{
+						if (auto& entry = unpacked[pos])
+						{
+							m_storage.add_pipeline_entry(std::get<1>(*entry), std::get<2>(*entry), std::get<0>(*entry), std::forward<Args>(args)...);
+						}
+
+						compiled++;
+					}
+
+					if (m_worker_exit)
+					{
+						m_worker_exit(index);
+					}
+				};
 
-			if (g_cfg.video.renderer == video_renderer::vulkan)
-			{
 				// Start workers
 				for (u32 i = 0; i < nb_threads; i++)
 				{
@@ -629,21 +718,22 @@ namespace rsx
 				}
 
 				// Wait for the workers to finish their task while updating UI
-				u32 current_progress = 0;
-				u32 last_update_progress = 0;
+				u32 last_progress[2] = {};
 
-				while ((current_progress < entry_count) && !Emu.IsStopped())
+				while ((last_progress[1] < entry_count) && !Emu.IsStopped())
 				{
 					std::this_thread::sleep_for(100ms); // Around 10fps should be good enough
 
-					current_progress = std::min(processed.load(), entry_count);
-					processed_since_last_update = current_progress - last_update_progress;
-					last_update_progress = current_progress;
+					const u32 current_progress[2] = { std::min(preloaded.load(), entry_count), std::min(compiled.load(), entry_count) };
 
-					if (processed_since_last_update > 0)
+					for (u32 index = 0; index < 2; index++)
 					{
-						dlg->update_msg(1, current_progress, entry_count);
-						dlg->inc_value(1, processed_since_last_update);
+						if (const u32 delta = current_progress[index] - last_progress[index])
+						{
+							dlg->update_msg(index, current_progress[index], entry_count);
+							dlg->inc_value(index, delta);
+							last_progress[index] = current_progress[index];
+						}
 					}
 				}
 
@@ -653,8 +743,32 @@ namespace rsx
 			}
 			else
 			{
-				u32 pos;
-				while (((pos = processed++) < entry_count) && !Emu.IsStopped())
+				// Preload everything needed to compile the shaders
+				std::vector<unpacked_type> unpacked;
+
+				for (u32 i = 0; (i < entry_count) && !Emu.IsStopped(); i++)
+				{
+					if (auto entry = load_entry(i))
+					{
+						unpacked.push_back(std::move(*entry));
+					}
+
+					// Only update the screen at about 10fps since updating it everytime slows down the process
+					std::chrono::time_point<steady_clock> now = std::chrono::steady_clock::now();
+					processed_since_last_update++;
+					if ((std::chrono::duration_cast<std::chrono::milliseconds>(now - last_update) > 100ms) || (i == entry_count - 1))
+					{
+						dlg->update_msg(0, i + 1, entry_count);
+						dlg->inc_value(0, processed_since_last_update);
+						last_update = now;
+						processed_since_last_update = 0;
+					}
+				}
+
+				// Account for any invalid entries
+				entry_count = u32(unpacked.size());
+
+				for (u32 pos = 0; (pos < entry_count) && !Emu.IsStopped(); pos++)
 				{
 					auto& entry = unpacked[pos];
 					m_storage.add_pipeline_entry(std::get<1>(entry), std::get<2>(entry), std::get<0>(entry), std::forward<Args>(args)...);
@@ -672,16 +786,6 @@ namespace rsx
 				}
 			}
 
-			if (!invalid_entries.empty())
-			{
-				for (const auto &filename : invalid_entries)
-				{
-					fs::remove_file(filename);
-				}
-
-				LOG_NOTICE(RSX, "shader cache: %d entries were marked as invalid and removed", invalid_entries.size());
-			}
-
 			dlg->refresh();
 			dlg->close();
 		}
@@ -700,19 +804,21 @@ namespace rsx
 			}
 
 			pipeline_data data = pack(pipeline, vp, fp);
-			std::string fp_name = root_path + "/raw/" + fmt::format("%llX.fp", data.fragment_program_hash);
-			std::string vp_name = root_path + "/raw/" + fmt::format("%llX.vp", data.vertex_program_hash);
 
-			if (!fs::is_file(fp_name))
-			{
-				fs::file(fp_name, fs::rewrite).write(fp.addr, fp.ucode_length);
-			}
+			std::lock_guard lock(m_pack_mutex);
 
-			if (!fs::is_file(vp_name))
+			if (!m_pack)
 			{
-				fs::file(vp_name, fs::rewrite).write<u32>(vp.data);
+				// Stored before load()
+				open_pack_import();
 			}
 
+			append_entry(data, vp.data.data(), ::size32(vp.data) * 4, fp.addr, fp.ucode_length);
+		}
+
+	private:
+		static u64 pipeline_key(const pipeline_data& data)
+		{
 			u64 state_hash = 0;
 			state_hash ^= rpcs3::hash_base<u32>(data.vp_ctrl);
 			state_hash ^= rpcs3::hash_base<u32>(data.fp_ctrl);
@@ -727,46 +833,229 @@ namespace rsx
 			state_hash ^= rpcs3::hash_base<u16>(data.fp_alphakill_mask);
 			state_hash ^= rpcs3::hash_base<u64>(data.fp_zfunc_mask);
 
-			std::string pipeline_file_name = fmt::format("%llX+%llX+%llX+%llX.bin", data.vertex_program_hash, data.fragment_program_hash, data.pipeline_storage_hash, state_hash);
-			std::string pipeline_path = root_path + "/pipelines/" + pipeline_class_name + "/" + version_prefix + "/" + pipeline_file_name;
-			fs::file(pipeline_path, fs::rewrite).write(&data, sizeof(pipeline_data));
+			const std::array<u64, 4> key{data.vertex_program_hash, data.fragment_program_hash, data.pipeline_storage_hash, state_hash};
+			return rpcs3::hash_struct(key);
 		}
 
-		RSXVertexProgram load_vp_raw(u64 program_hash)
+		static u64 pack_checksum(const pack_record& rec, const void* data)
 		{
-			std::vector<u32> data;
-			std::string filename = fmt::format("%llX.vp", program_hash);
+			// FNV 64-bit over record header and payload
+			u64 result = 14695981039346656037ull ^ rec.type ^ (u64{rec.size} << 32) ^ rec.key;
+			const u8* bytes = static_cast<const u8*>(data);
 
-			fs::file f(root_path + "/raw/" + filename);
-			f.read<u32>(data, f.size() / sizeof(u32));
+			for (u32 i = 0; i < rec.size; i++)
+			{
+				result ^= bytes[i];
+				result *= 1099511628211ull;
+			}
+
+			return result;
+		}
+
+		// Append a record with a single write (a torn write is detected by the checksum on next load)
+		u64 pack_append(u32 type, u64 key, const void* data, u32 size)
+		{
+			pack_record rec{type, size, key, 0};
+			rec.checksum = pack_checksum(rec, data);
+
+			std::vector<u8> buffer(sizeof(pack_record) + size);
+			std::memcpy(buffer.data(), &rec, sizeof(pack_record));
+			std::memcpy(buffer.data() + sizeof(pack_record), data, size);
+
+			const u64 offset = m_pack.size();
+			m_pack.write(buffer.data(), buffer.size());
+			return offset;
+		}
+
+		// Append pipeline with its programs (unless already present), m_pack_mutex must be locked
+		void append_entry(const pipeline_data& data, const void* vp, u32 vp_size, const void* fp, u32 fp_size)
+		{
+			if (!m_pack || !m_pipeline_keys.emplace(pipeline_key(data)).second)
+			{
+				return;
+			}
+
+			if (!m_vp_index.count(data.vertex_program_hash))
+			{
+				m_vp_index.emplace(data.vertex_program_hash, pack_append(pack_vertex_program, data.vertex_program_hash, vp, vp_size));
+			}
+
+			if (!m_fp_index.count(data.fragment_program_hash))
+			{
+				m_fp_index.emplace(data.fragment_program_hash, pack_append(pack_fragment_program, data.fragment_program_hash, fp, fp_size));
+			}
+
+			m_pipeline_offsets.push_back(pack_append(pack_pipeline, pipeline_key(data), &data, sizeof(pipeline_data)));
+		}
+
+		// Open packed cache file, validate records and rebuild the index, returns file contents
+		std::vector<u8> open_pack()
+		{
+			m_vp_index.clear();
+			m_fp_index.clear();
+			m_pipeline_keys.clear();
+			m_pipeline_offsets.clear();
+
+			std::vector<u8> data;
+
+			if (!m_pack.open(pack_path, fs::read + fs::write + fs::create + fs::append))
+			{
+				LOG_ERROR(RSX, "shaders_cache: failed to open %s (%s)", pack_path, fs::g_tls_error);
+				return data;
+			}
+
+			data = m_pack.to_vector<u8>();
+
+			const pack_header header{pack_magic, pack_version, sizeof(pipeline_data)};
+
+			if (data.size() < sizeof(pack_header) || std::memcmp(data.data(), &header, sizeof(pack_header)) != 0)
+			{
+				if (!data.empty())
+				{
+					LOG_WARNING(RSX, "shaders_cache: %s is not compatible with the current shader cache and will be rebuilt", pack_path);
+				}
+
+				m_pack.trunc(0);
+				m_pack.write(&header, sizeof(pack_header));
+				data.clear();
+				return data;
+			}
+
+			u64 pos = sizeof(pack_header);
+
+			while (pos + sizeof(pack_record) <= data.size())
+			{
+				pack_record rec;
+				std::memcpy(&rec, data.data() + pos, sizeof(pack_record));
+
+				const u8* payload = data.data() + pos + sizeof(pack_record);
+
+				if (rec.size > data.size() - pos - sizeof(pack_record) || rec.checksum != pack_checksum(rec, payload))
+				{
+					break;
+				}
+
+				switch (rec.type)
+				{
+				case pack_vertex_program: m_vp_index.emplace(rec.key, pos); break;
+				case pack_fragment_program: m_fp_index.emplace(rec.key, pos); break;
+				case pack_pipeline:
+				{
+					if (rec.size == sizeof(pipeline_data) && m_pipeline_keys.emplace(rec.key).second)
+					{
+						m_pipeline_offsets.push_back(pos);
+					}
+
+					break;
+				}
+				default: break;
+				}
+
+				pos += sizeof(pack_record) + rec.size;
+			}
+
+			if (pos != data.size())
+			{
+				// Recover from interrupted write by dropping the incomplete tail
+				LOG_WARNING(RSX, "shaders_cache: %s: discarding %u bytes of incomplete data", pack_path, data.size() - pos);
+				m_pack.trunc(pos);
+				data.resize(pos);
+			}
+
+			return data;
+		}
+
+		// Open packed cache file, import the old layout if the pack has no pipelines yet (by load() or store(), whichever comes first)
+		std::vector<u8> open_pack_import()
+		{
+			// Old layout: one file per pipeline
+			const std::string directory_path = root_path + "/pipelines/" + pipeline_class_name + "/" + version_prefix;
+
+			auto data = open_pack();
+
+			if (m_pack && m_pipeline_offsets.empty() && fs::is_dir(directory_path))
+			{
+				import_legacy(directory_path);
+				data = open_pack();
+			}
+
+			return data;
+		}
+
+		// One-time import of the old layout (one file per pipeline and raw/*.vp, raw/*.fp)
+		void import_legacy(const std::string& directory_path)
+		{
+			u32 count = 0;
+
+			for (const auto& entry : fs::dir(directory_path))
+			{
+				if (entry.is_directory)
+				{
+					continue;
+				}
+
+				fs::file f(directory_path + "/" + entry.name);
+
+				if (!f || f.size() != sizeof(pipeline_data))
+				{
+					continue;
+				}
+
+				pipeline_data data;
+				f.read(&data, sizeof(pipeline_data));
+
+				fs::file vp(root_path + "/raw/" + fmt::format("%llX.vp", data.vertex_program_hash));
+				fs::file fp(root_path + "/raw/" + fmt::format("%llX.fp", data.fragment_program_hash));
+
+				if (!vp || !fp)
+				{
+					continue;
+				}
+
+				const auto vp_data = vp.to_vector<u8>();
+				const auto fp_data = fp.to_vector<u8>();
+
+				append_entry(data, vp_data.data(), ::size32(vp_data), fp_data.data(), ::size32(fp_data));
+				count++;
+			}
+
+			LOG_NOTICE(RSX, "shaders_cache: imported %u pipeline entries from %s", count, directory_path);
+		}
+
+		RSXVertexProgram load_vp_raw(const std::vector<u8>& pack, u64 offset)
+		{
+			pack_record rec;
+			std::memcpy(&rec, pack.data() + offset, sizeof(pack_record));
 
 			RSXVertexProgram vp = {};
-			vp.data = data;
+			vp.data.resize(rec.size / sizeof(u32));
+			std::memcpy(vp.data.data(), pack.data() + offset + sizeof(pack_record), vp.data.size() * sizeof(u32));
 			vp.skip_vertex_input_check = true;
 
 			return vp;
 		}
 
-		RSXFragmentProgram load_fp_raw(u64 program_hash)
+		RSXFragmentProgram load_fp_raw(const std::vector<u8>& pack, u64 offset)
 		{
-			std::vector<u8> data;
-			std::string filename = fmt::format("%llX.fp", program_hash);
+			pack_record rec;
+			std::memcpy(&rec, pack.data() + offset, sizeof(pack_record));
+
+			const u8* ptr = pack.data() + offset + sizeof(pack_record);
 
-			fs::file f(root_path + "/raw/" + filename);
-			f.read<u8>(data, f.size());
+			// Existing data is left untouched, it may be in use by another loader thread
+			const auto found = fragment_program_data.try_emplace(rec.key, ptr, ptr + rec.size).first;
 
 			RSXFragmentProgram fp = {};
-			fragment_program_data[program_hash] = data;
-			fp.addr = fragment_program_data[program_hash].data();
-			fp.ucode_length = (u32)data.size();
+			fp.addr = found->second.data();
+			fp.ucode_length = rec.size;
 
 			return fp;
 		}
 
-		std::tuple<pipeline_storage_type, RSXVertexProgram, RSXFragmentProgram> unpack(pipeline_data &data)
+		std::tuple<pipeline_storage_type, RSXVertexProgram, RSXFragmentProgram> unpack(pipeline_data &data, const std::vector<u8>& pack, u64 vp_offset, u64 fp_offset)
 		{
-			RSXVertexProgram vp = load_vp_raw(data.vertex_program_hash);
-			RSXFragmentProgram fp = load_fp_raw(data.fragment_program_hash);
+			RSXVertexProgram vp = load_vp_raw(pack, vp_offset);
+			RSXFragmentProgram fp = load_fp_raw(pack, fp_offset);
 			pipeline_storage_type pipeline = data.pipeline_properties;
 
 			vp.output_mask = data.vp_ctrl;
@@ -14,6 +14,7 @@
 #include "Emu/Cell/lv2/sys_sync.h"
 #include "Emu/Cell/lv2/sys_prx.h"
 #include "Emu/Cell/lv2/sys_rsx.h"
+#include "Emu/Cell/lv2/sys_timer.h"
 
 #include "Emu/IdManager.h"
 #include "Emu/RSX/GSRender.h"
@@ -58,6 +59,7 @@ extern atomic_t<u32> g_thread_count;
 
 extern void ppu_load_exec(const ppu_exec_object&);
 extern void spu_load_exec(const spu_exec_object&);
+extern void ppu_initialize();
 extern void ppu_initialize(const ppu_module&);
 extern void ppu_unload_prx(const lv2_prx&);
 extern std::shared_ptr<lv2_prx> ppu_load_prx(const ppu_prx_object&, const std::string&);
@@ -361,24 +363,28 @@ void Emulator::Init()
 					std::this_thread::sleep_for(5ms);
 				}
 
-				// Initialize message dialog
+				// Initialize message dialog (may be unavailable without GUI)
 				std::shared_ptr<MsgDialogBase> dlg = Emu.GetCallbacks().get_msg_dialog();
-				dlg->type.se_normal = true;
-				dlg->type.bg_invisible = true;
-				dlg->type.progress_bar_count = 1;
-				dlg->on_close = [](s32 status)
+
+				if (dlg)
 				{
-					Emu.CallAfter([]()
+					dlg->type.se_normal = true;
+					dlg->type.bg_invisible = true;
+					dlg->type.progress_bar_count = 1;
+					dlg->on_close = [](s32 status)
 					{
-						// Abort everything
-						Emu.Stop();
-					});
-				};
+						Emu.CallAfter([]()
+						{
+							// Abort everything
+							Emu.Stop();
+						});
+					};
 
-				Emu.CallAfter([=]()
-				{
-					dlg->Create(+g_progr, +g_progr);
-				});
+					Emu.CallAfter([=]()
+					{
+						dlg->Create(+g_progr, +g_progr);
+					});
+				}
 
 				u64 ftotal = 0;
 				u64 fdone = 0;
@@ -416,6 +422,14 @@ void Emulator::Init()
 							if (ptotal)
 								fmt::append(progr, " module %u of %u", pdone, ptotal);
 
+							if (!dlg)
+							{
+								// Print progress to the log instead
+								if (delta)
+									LOG_NOTICE(GENERAL, "%s %s", +g_progr, progr);
+								return;
+							}
+
 							dlg->SetMsg(+g_progr);
 							dlg->ProgressBarSetMsg(0, progr);
 							dlg->ProgressBarInc(0, delta);
@@ -437,10 +451,13 @@ void Emulator::Init()
 				g_progr_ptotal -= pdone;
 				g_progr_pdone  -= pdone;
 
-				Emu.CallAfter([=]
+				if (dlg)
 				{
-					dlg->Close(true);
-				});
+					Emu.CallAfter([=]
+					{
+						dlg->Close(true);
+					});
+				}
 			}
 		});
 
@@ -534,6 +551,24 @@ bool Emulator::BootRsxCapture(const std::string& path)
 	return true;
 }
 
+bool Emulator::BuildCaches(const std::string& path)
+{
+	// Load the game in cache build mode (see Load())
+	m_cache_build = true;
+	m_cache_build_ok = false;
+
+	const bool result = BootGame(path, "", fs::is_file(path)) && !IsStopped();
+
+	m_cache_build = false;
+
+	if (!result)
+	{
+		LOG_ERROR(LOADER, "Failed to build caches: %s", path);
+	}
+
+	return result;
+}
+
 void Emulator::LimitCacheSize()
 {
 	const std::string cache_location = Emulator::GetHdd1Dir() + "/cache";
@@ -811,6 +846,110 @@ void Emulator::SetForceBoot(bool force_boot)
 	m_force_boot = force_boot;
 }
 
+// Load and compile all SPRX libraries found in the directories (recursively)
+static void ppu_precompile(std::vector<std::string> dir_queue, u8* klic)
+{
+	std::vector<std::pair<std::string, u64>> file_queue;
+	file_queue.reserve(2000);
+
+	std::queue<named_thread<std::function<void()>>> thread_queue;
+	const uint max_threads = std::thread::hardware_concurrency();
+
+	// Initialize progress dialog
+	g_progr = "Scanning directories for SPRX libraries...";
+
+	// Find all .sprx files recursively (TODO: process .mself files)
+	for (std::size_t i = 0; i < dir_queue.size(); i++)
+	{
+		if (Emu.IsStopped())
+		{
+			break;
+		}
+
+		LOG_NOTICE(LOADER, "Scanning directory: %s", dir_queue[i]);
+
+		for (auto&& entry : fs::dir(dir_queue[i]))
+		{
+			if (Emu.IsStopped())
+			{
+				break;
+			}
+
+			if (entry.is_directory)
+			{
+				if (entry.name != "." && entry.name != "..")
+				{
+					dir_queue.emplace_back(dir_queue[i] + entry.name + '/');
+				}
+
+				continue;
+			}
+
+			// Check .sprx filename
+			if (entry.name.size() >= 5 && fmt::to_upper(entry.name).compare(entry.name.size() - 5, 5, ".SPRX", 5) == 0)
+			{
+				if (entry.name == "libfs_155.sprx")
+				{
+					continue;
+				}
+
+				// Get full path
+				file_queue.emplace_back(dir_queue[i] + entry.name, 0);
+				g_progr_ftotal++;
+			}
+		}
+	}
+
+	g_progr = "Compiling PPU modules";
+
+	for (std::size_t i = 0; i < file_queue.size(); i++)
+	{
+		const auto& path = file_queue[i].first;
+
+		LOG_NOTICE(LOADER, "Trying to load SPRX: %s", path);
+
+		// Load MSELF or SPRX
+		fs::file src{path};
+
+		if (file_queue[i].second == 0)
+		{
+			// Some files may fail to decrypt due to the lack of klic
+			src = decrypt_self(std::move(src), klic);
+		}
+
+		const ppu_prx_object obj = src;
+
+		if (obj == elf_error::ok)
+		{
+			if (auto prx = ppu_load_prx(obj, path))
+			{
+				while (g_thread_count >= max_threads + 2)
+				{
+					std::this_thread::sleep_for(10ms);
+				}
+
+				thread_queue.emplace("Worker " + std::to_string(thread_queue.size()), [_prx = std::move(prx)]
+				{
+					ppu_initialize(*_prx);
+					ppu_unload_prx(*_prx);
+					g_progr_fdone++;
+				});
+
+				continue;
+			}
+		}
+
+		LOG_ERROR(LOADER, "Failed to load SPRX '%s' (%s)", path, obj.get_error());
+		g_progr_fdone++;
+	}
+
+	// Join every thread
+	while (!thread_queue.empty())
+	{
+		thread_queue.pop();
+	}
+}
+
 void Emulator::Load(const std::string& title_id, bool add_only, bool force_global_config)
 {
 	if (!IsStopped())
@@ -951,6 +1090,9 @@ void Emulator::Load(const std::string& title_id, bool add_only, bool force_globa
 		// Load patches from different locations
 		fxm::check_unlocked<patch_engine>()->append(fs::get_config_dir() + "data/" + m_title_id + "/patch.yml");
 
+		// Initialize lv2 timer wheel (destroyed with fxm::clear on stop)
+		fxm::make<lv2_timer_wheel>();
+
 		// Mount all devices
 		const std::string emu_dir = GetEmuDir();
 		const std::string home_dir = g_cfg.vfs.app_home;
@@ -981,108 +1123,7 @@ void Emulator::Load(const std::string& title_id, bool add_only, bool force_globa
 
 			return thread_ctrl::spawn("SPRX Loader", [this]
 			{
-				std::vector<std::string> dir_queue;
-				dir_queue.emplace_back(m_path + '/');
-
-				std::vector<std::pair<std::string, u64>> file_queue;
-				file_queue.reserve(2000);
-
-				std::queue<named_thread<std::function<void()>>> thread_queue;
-				const uint max_threads = std::thread::hardware_concurrency();
-
-				// Initialize progress dialog
-				g_progr = "Scanning directories for SPRX libraries...";
-
-				// Find all .sprx files recursively (TODO: process .mself files)
-				for (std::size_t i = 0; i < dir_queue.size(); i++)
-				{
-					if (Emu.IsStopped())
-					{
-						break;
-					}
-
-					LOG_NOTICE(LOADER, "Scanning directory: %s", dir_queue[i]);
-
-					for (auto&& entry : fs::dir(dir_queue[i]))
-					{
-						if (Emu.IsStopped())
-						{
-							break;
-						}
-
-						if (entry.is_directory)
-						{
-							if (entry.name != "." && entry.name != "..")
-							{
-								dir_queue.emplace_back(dir_queue[i] + entry.name + '/');
-							}
-
-							continue;
-						}
-
-						// Check .sprx filename
-						if (entry.name.size() >= 5 && fmt::to_upper(entry.name).compare(entry.name.size() - 5, 5, ".SPRX", 5) == 0)
-						{
-							if (entry.name == "libfs_155.sprx")
-							{
-								continue;
-							}
-
-							// Get full path
-							file_queue.emplace_back(dir_queue[i] + entry.name, 0);
-							g_progr_ftotal++;
-						}
-					}
-				}
-
-				g_progr = "Compiling PPU modules";
-
-				for (std::size_t i = 0; i < file_queue.size(); i++)
-				{
-					const auto& path = file_queue[i].first;
-
-					LOG_NOTICE(LOADER, "Trying to load SPRX: %s", path);
-
-					// Load MSELF or SPRX
-					fs::file src{path};
-
-					if (file_queue[i].second == 0)
-					{
-						// Some files may fail to decrypt due to the lack of klic
-						src = decrypt_self(std::move(src));
-					}
-
-					const ppu_prx_object obj = src;
-
-					if (obj == elf_error::ok)
-					{
-						if (auto prx = ppu_load_prx(obj, path))
-						{
-							while (g_thread_count >= max_threads + 2)
-							{
-								std::this_thread::sleep_for(10ms);
-							}
-
-							thread_queue.emplace("Worker " + std::to_string(thread_queue.size()), [_prx = std::move(prx)]
-							{
-								ppu_initialize(*_prx);
-								ppu_unload_prx(*_prx);
-								g_progr_fdone++;
-							});
-
-							continue;
-						}
-					}
-
-					LOG_ERROR(LOADER, "Failed to load SPRX '%s' (%s)", path, obj.get_error());
-					g_progr_fdone++;
-				}
-
-				// Join every thread
-				while (!thread_queue.empty())
-				{
-					thread_queue.pop();
-				}
+				ppu_precompile({m_path + '/'}, nullptr);
 
 				// Exit "process"
 				Emu.CallAfter([]
@@ -1443,6 +1484,47 @@ void Emulator::Load(const std::string& title_id, bool add_only, bool force_globa
 				LOG_NOTICE(LOADER, "Cache: %s", _main->cache);
 			}
 
+			// Cache build mode (compile everything without running)
+			if (m_cache_build)
+			{
+				m_cache_build = false;
+
+				// Force LLVM recompiler for this run only
+				const ppu_decoder_type old_decoder = g_cfg.core.ppu_decoder;
+				g_cfg.core.ppu_decoder.set(ppu_decoder_type::llvm);
+
+				return thread_ctrl::spawn("Cache Builder", [elf_dir, klic = klic, old_decoder]() mutable
+				{
+					// Compile the executable with preloaded libraries, and SPU cache
+					ppu_initialize();
+
+					// Compile game libraries and firmware LLE modules
+					ppu_precompile({elf_dir + '/', vfs::get("/dev_flash/sys/external/")}, klic.empty() ? nullptr : klic.data());
+
+					if (!Emu.IsStopped())
+					{
+						LOG_SUCCESS(LOADER, "Cache building finished.");
+						Emu.m_cache_build_ok = true;
+					}
+					else
+					{
+						LOG_ERROR(LOADER, "Cache building aborted.");
+					}
+
+					// Exit "process"
+					Emu.CallAfter([old_decoder]
+					{
+						if (!Emu.IsStopped())
+						{
+							// Restore the decoder (if already stopped, configuration has been reloaded)
+							g_cfg.core.ppu_decoder.set(old_decoder);
+						}
+
+						Emu.Stop();
+					});
+				});
+			}
+
 			fxm::import<GSRender>(Emu.GetCallbacks().get_gs_render); // TODO: must be created in appropriate sys_rsx syscall
 			fxm::import<pad_thread>(Emu.GetCallbacks().get_pad_handler, m_title_id);
 			network_thread_init();
@@ -1473,6 +1555,15 @@ void Emulator::Load(const std::string& title_id, bool add_only, bool force_globa
 			return;
 		}
 
+		if (m_cache_build)
+		{
+			// Cache build mode is only consumed by PPU executables, otherwise it would never finish
+			LOG_ERROR(LOADER, "Cannot build caches: not a PPU executable: %s", elf_path);
+			m_cache_build = false;
+			Stop();
+			return;
+		}
+
 		if ((m_force_boot || g_cfg.misc.autostart) && IsReady())
 		{
 			Run();
@@ -1645,6 +1736,22 @@ void Emulator::Stop(bool restart)
 	fxm::remove<GDBDebugServer>();
 #endif
 
+	if (g_cfg.core.cpu_stats_dump)
+	{
+		// Snapshot must be taken before threads unregister
+		const std::string path = fs::get_cache_dir() + "cpu_stats.json";
+
+		if (fs::file stats{path, fs::rewrite})
+		{
+			stats.write(cpu_thread::get_stats_json());
+			LOG_NOTICE(GENERAL, "CPU thread stats saved to %s", path);
+		}
+		else
+		{
+			LOG_ERROR(GENERAL, "Failed to write %s (%s)", path, fs::g_tls_error);
+		}
+	}
+
 	auto on_select = [&](u32, cpu_thread& cpu)
 	{
 		cpu.state += cpu_flag::dbg_global_stop;
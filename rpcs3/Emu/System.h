@@ -231,6 +231,8 @@ class Emulator final
 	u32 m_usrid{1};
 
 	bool m_force_boot = false;
+	bool m_cache_build = false;
+	atomic_t<bool> m_cache_build_ok{false};
 
 public:
 	Emulator() = default;
@@ -320,6 +322,14 @@ public:
 
 	bool BootGame(const std::string& path, const std::string& title_id = "", bool direct = false, bool add_only = false, bool force_global_config = false);
 	bool BootRsxCapture(const std::string& path);
+	bool BuildCaches(const std::string& path);
+
+	// Check if the last cache build has completed (valid after the emulator has stopped)
+	bool IsCacheBuildOk() const
+	{
+		return m_cache_build_ok;
+	}
+
 	bool InstallPkg(const std::string& path);
 
 private:
@@ -378,6 +388,7 @@ struct cfg_root : cfg::node
 		cfg::_enum<spu_decoder_type> spu_decoder{this, "SPU Decoder", spu_decoder_type::asmjit};
 		cfg::_bool lower_spu_priority{this, "Lower SPU thread priority"};
 		cfg::_bool spu_debug{this, "SPU Debug"};
+		cfg::_bool cpu_stats_dump{this, "Dump CPU thread stats", false}; // Write per-thread time accounting to cpu_stats.json on stop
 		cfg::_int<0, 6> preferred_spu_threads{this, "Preferred SPU Threads", 0}; //Numnber of hardware threads dedicated to heavy simultaneous spu tasks
 		cfg::_int<0, 16> spu_delay_penalty{this, "SPU delay penalty", 3}; //Number of milliseconds to block a thread if a virtual 'core' isn't free
 		cfg::_bool spu_loop_detection{this, "SPU loop detection", true}; //Try to detect wait loops and trigger thread yield
@@ -385,8 +396,12 @@ struct cfg_root : cfg::node
 		cfg::_enum<spu_block_size_type> spu_block_size{this, "SPU Block Size", spu_block_size_type::safe};
 		cfg::_bool spu_accurate_getllar{this, "Accurate GETLLAR", false};
 		cfg::_bool spu_accurate_putlluc{this, "Accurate PUTLLUC", false};
+		cfg::_bool spu_lockless_putllc{this, "Lockless PUTLLC", false}; // Don't take the writer lock on PUTLLC without TSX (not atomic against PPU stores)
 		cfg::_bool spu_verification{this, "SPU Verification", true}; // Should be enabled
 		cfg::_bool spu_cache{this, "SPU Cache", true};
+		cfg::_bool spu_tiered_compilation{this, "SPU Tiered Compilation", false}; // Run new SPU code with ASMJIT until LLVM version is ready
+		cfg::_bool spu_profiling{this, "SPU Profiling", false}; // Collect SPU execution counters for profile-guided recompilation
+		cfg::_int<0, 1024> spu_jit_budget{this, "SPU JIT Memory Budget", 0}; // MiB, evict cold SPU functions when exceeded (0 = disabled)
 		cfg::_enum<tsx_usage> enable_TSX{this, "Enable TSX", tsx_usage::enabled}; // Enable TSX. Forcing this on Haswell/Broadwell CPUs should be used carefully
 		cfg::_bool spu_accurate_xfloat{this, "Accurate xfloat", false};
 		cfg::_bool spu_approx_xfloat{this, "Approximate xfloat", true};
@@ -459,6 +474,7 @@ struct cfg_root : cfg::node
 		cfg::_bool disable_vulkan_mem_allocator{this, "Disable Vulkan Memory Allocator", false};
 		cfg::_bool full_rgb_range_output{this, "Use full RGB output range", true}; // Video out dynamic range
 		cfg::_bool disable_asynchronous_shader_compiler{this, "Disable Asynchronous Shader Compiler", false};
+		cfg::_int<0, 16> shader_compiler_threads{this, "Shader Compiler Threads", 0}; // Asynchronous shader compiler workers (0 = auto)
 		cfg::_bool strict_texture_flushing{this, "Strict Texture Flushing", false};
 		cfg::_bool disable_native_float16{this, "Disable native float16 support", false};
 		cfg::_int<1, 8> consequtive_frames_to_draw{this, "Consecutive Frames To Draw", 1};
@@ -8,7 +8,9 @@
 #include <QObject>
 
 #include "rpcs3_app.h"
+#include "Emu/System.h"
 #include "Utilities/sema.h"
+#include "Utilities/lockless.h"
 #ifdef _WIN32
 #include <windows.h>
 #endif
@@ -90,6 +92,47 @@ static semaphore<> s_qt_mutex{};
 	std::abort();
 }
 
+// Build PPU/SPU caches of the game without GUI, renderer or audio
+static int run_cache_builder(const std::string& path)
+{
+	// Functions queued by CallAfter (executed on this thread)
+	lf_queue<std::function<void()>> queue;
+
+	EmuCallbacks callbacks;
+	callbacks.call_after = [&](std::function<void()> func) { queue.push(std::move(func)); };
+	callbacks.on_run = [] {};
+	callbacks.on_pause = [] {};
+	callbacks.on_resume = [] {};
+	callbacks.on_stop = [] {};
+	callbacks.on_ready = [] {};
+	callbacks.exit = [] {};
+	callbacks.reset_pads = [](const std::string&) {};
+	callbacks.enable_pads = [](bool) {};
+	callbacks.handle_taskbar_progress = [](s32, s32) {};
+	callbacks.get_msg_dialog = []() -> std::shared_ptr<MsgDialogBase> { return nullptr; };
+
+	Emu.SetCallbacks(std::move(callbacks));
+	Emu.Init();
+
+	if (!Emu.BuildCaches(path))
+	{
+		return 1;
+	}
+
+	// Process queued functions until the emulator is stopped
+	while (!Emu.IsStopped())
+	{
+		for (auto slice = queue.pop_all(); slice; slice.pop_front())
+		{
+			(*slice)();
+		}
+
+		queue.wait(10000);
+	}
+
+	return Emu.IsCacheBuildOk() ? 0 : 1;
+}
+
 int main(int argc, char** argv)
 {
 	logs::set_init();
@@ -108,6 +151,13 @@ int main(int argc, char** argv)
 		std::fprintf(stderr, "Failed to set max open file limit (4096).");
 #endif
 
+	// Headless cache build mode: rpcs3 --build-cache <game path>
+	if (argc == 3 && std::strcmp(argv[1], "--build-cache") == 0)
+	{
+		s_init.unlock();
+		return run_cache_builder(argv[2]);
+	}
+
 	QCoreApplication::setAttribute(Qt::AA_UseHighDpiPixmaps);
 	QCoreApplication::setAttribute(Qt::AA_DisableWindowContextHelpButton);
 	QCoreApplication::setAttribute(Qt::AA_DontCheckOpenGLContextThreadAffinity);
@@ -1151,7 +1151,7 @@ bool game_list_frame::RemovePPUCache(const std::string& base_dir, bool is_intera
 	{
 		const QString filepath = dir_iter.next();
 
-		if (dir_iter.fileInfo().absoluteFilePath().endsWith(".obj", Qt::CaseInsensitive))
+		if (dir_iter.fileInfo().absoluteFilePath().endsWith(".obj", Qt::CaseInsensitive) || dir_iter.fileInfo().absoluteFilePath().endsWith(".jar", Qt::CaseInsensitive))
 		{
 			if (QFile::remove(filepath))
 			{